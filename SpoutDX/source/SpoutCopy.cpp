@@ -75,6 +75,9 @@
 	Version 2.007.014
 	19.06.24 - Add ClearAlpha
 	07.02.25 - Add GetSSE to return SSE capability
+	18.10.26 - Add hdr2rgba for R10G10B10A2, R16G16B16A16_UNORM and R16G16B16A16_FLOAT
+			   texture data to 8 bit RGBA/BGRA/RGB/BGR pixels with optional sRGB encoding
+			 - Add BlendPixels for frame rate conversion
 
 //
 void spoutCopy::GetSSE
@@ -304,6 +307,51 @@ void spoutCopy::memcpy_sse2(void* dst, const void* src, size_t Size) const
 
 }
 
+//---------------------------------------------------------
+// Function: BlendPixels
+// Linear blend of two pixel buffers of the same size and format.
+//
+// Each byte is (source1*(256 - weight) + source2*weight)/256,
+// so weight 0 is source1 and 256 is source2.
+// Byte order does not matter, so any 8 bit per channel format can be used.
+void spoutCopy::BlendPixels(const void* source1, const void* source2, void* dest,
+	size_t size, unsigned int weight) const
+{
+	if (!source1 || !source2 || !dest || size == 0)
+		return;
+
+	if (weight > 256)
+		weight = 256;
+
+	auto pSrc1 = static_cast<const unsigned char*>(source1);
+	auto pSrc2 = static_cast<const unsigned char*>(source2);
+	auto pDst = static_cast<unsigned char*>(dest);
+	size_t i = 0;
+
+	if (m_bSSE2) {
+		// 16 bytes per cycle as 2 x 8 16 bit values
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i w2 = _mm_set1_epi16((short)weight);
+		const __m128i w1 = _mm_set1_epi16((short)(256 - weight));
+		for (; i + 16 <= size; i += 16) {
+			const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc1 + i));
+			const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc2 + i));
+			const __m128i lo = _mm_srli_epi16(_mm_add_epi16(
+				_mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), w1),
+				_mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), w2)), 8);
+			const __m128i hi = _mm_srli_epi16(_mm_add_epi16(
+				_mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), w1),
+				_mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), w2)), 8);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i), _mm_packus_epi16(lo, hi));
+		}
+	}
+
+	// Remaining bytes
+	for (; i < size; i++)
+		pDst[i] = (unsigned char)((pSrc1[i]*(256 - weight) + pSrc2[i]*weight) >> 8);
+
+}
+
 //
 // Group: RGBA <> RGBA
 //
@@ -1691,3 +1739,267 @@ void spoutCopy::rgba_bgra_sse3(const void* rgba_source, void* bgra_dest, unsigne
 	}
 
 } // end rgba_bgra_sse3
+
+//
+// 10 bit, 16 bit and floating point textures
+//
+// Texture data is converted line by line to 8 bit RGBA in a line buffer
+// and then packed to the destination in the same pass.
+//
+
+// Half float to 8 bit conversion tables, linear and sRGB encoded.
+// Created once on first use.
+static float HalfToFloat(uint16_t h)
+{
+	const uint32_t sign = (uint32_t)(h & 0x8000) << 16;
+	uint32_t exponent = (h >> 10) & 0x1F;
+	uint32_t mantissa = h & 0x3FF;
+	uint32_t bits = 0;
+
+	if (exponent == 0) {
+		if (mantissa != 0) {
+			// Denormal - normalize
+			exponent = 113;
+			while ((mantissa & 0x400) == 0) {
+				mantissa <<= 1;
+				exponent--;
+			}
+			mantissa &= 0x3FF;
+			bits = sign | (exponent << 23) | (mantissa << 13);
+		}
+		else {
+			bits = sign; // zero
+		}
+	}
+	else if (exponent == 31) {
+		bits = sign | 0x7F800000 | (mantissa << 13); // Inf or NaN
+	}
+	else {
+		bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+	}
+
+	float f = 0.0f;
+	memcpy(&f, &bits, 4);
+	return f;
+}
+
+static const unsigned char* HalfTable(bool bSRGB)
+{
+	static unsigned char linear[65536];
+	static unsigned char srgb[65536];
+	static const bool bCreated = []() {
+		for (unsigned int i = 0; i < 65536; i++) {
+			float f = HalfToFloat((uint16_t)i);
+			// Clamp to 0-1, NaN to 0
+			if (!(f > 0.0f)) f = 0.0f;
+			if (f > 1.0f) f = 1.0f;
+			linear[i] = (unsigned char)(f*255.0f + 0.5f);
+			float s = 0.0f;
+			if (f <= 0.0031308f)
+				s = f*12.92f;
+			else
+				s = 1.055f*std::pow(f, 1.0f/2.4f) - 0.055f;
+			srgb[i] = (unsigned char)(s*255.0f + 0.5f);
+		}
+		return true;
+	}();
+	(void)bCreated;
+	return bSRGB ? srgb : linear;
+}
+
+//---------------------------------------------------------
+// Function: hdr2rgba
+// Convert 10 bit, 16 bit and floating point texture data to 8 bit pixels.
+//
+//   dwFormat - 24 : DXGI_FORMAT_R10G10B10A2_UNORM
+//              11 : DXGI_FORMAT_R16G16B16A16_UNORM
+//              10 : DXGI_FORMAT_R16G16B16A16_FLOAT
+//   glFormat - GL_RGBA, GL_BGRA_EXT, GL_RGB or GL_BGR_EXT
+//   bSRGB    - encode linear floating point values as sRGB
+//
+// Returns false if the texture format is not supported.
+//
+bool spoutCopy::hdr2rgba(const void* source, void* dest,
+	unsigned int sourceWidth, unsigned int sourceHeight, unsigned int sourcePitch,
+	unsigned int destWidth, unsigned int destHeight,
+	DWORD dwFormat, GLenum glFormat,
+	bool bInvert, bool bMirror, bool bSRGB) const
+{
+	auto src = static_cast<const unsigned char*>(source);
+	auto dst = static_cast<unsigned char*>(dest);
+	if (!src || !dst || sourceWidth == 0 || sourceHeight == 0 || destWidth == 0 || destHeight == 0)
+		return false;
+
+	unsigned int bpp = 0; // Source bytes per pixel
+	if (dwFormat == 24)
+		bpp = 4;
+	else if (dwFormat == 11 || dwFormat == 10)
+		bpp = 8;
+	else
+		return false;
+
+	if (sourcePitch == 0)
+		sourcePitch = sourceWidth*bpp;
+
+	// Destination bytes per pixel and red/blue order
+	unsigned int dbpp = 4;
+	bool bSwapRB = false;
+	if (glFormat == GL_RGB || glFormat == GL_BGR_EXT)
+		dbpp = 3;
+	if (glFormat == GL_BGRA_EXT || glFormat == GL_BGR_EXT)
+		bSwapRB = true;
+	int ir = 0; int ig = 1; int ib = 2;
+	if (bSwapRB) {
+		ir = 2; ib = 0;
+	}
+
+	const bool bResample = (sourceWidth != destWidth || sourceHeight != destHeight);
+	const uint64_t destPitch = (uint64_t)destWidth*dbpp;
+
+	// Converted source line
+	unsigned char* line = new unsigned char[(size_t)sourceWidth*4];
+	unsigned int lastRow = 0xFFFFFFFF;
+
+	for (unsigned int y = 0; y < destHeight; y++) {
+
+		// Nearest source line
+		unsigned int sy = y;
+		if (bResample)
+			sy = (unsigned int)(((uint64_t)y*sourceHeight)/destHeight);
+
+		unsigned char* dline = dst;
+		if (bInvert)
+			dline += (uint64_t)(destHeight - y - 1)*destPitch;
+		else
+			dline += (uint64_t)y*destPitch;
+
+		// RGBA destination of the same size can be converted directly
+		if (!bResample && !bMirror && !bSwapRB && dbpp == 4) {
+			hdr_line_to_rgba(src + (uint64_t)sy*sourcePitch, dline, sourceWidth, dwFormat, bSRGB);
+			continue;
+		}
+
+		if (sy != lastRow) {
+			hdr_line_to_rgba(src + (uint64_t)sy*sourcePitch, line, sourceWidth, dwFormat, bSRGB);
+			lastRow = sy;
+		}
+
+		for (unsigned int x = 0; x < destWidth; x++) {
+			unsigned int sx = x;
+			if (bResample)
+				sx = (unsigned int)(((uint64_t)x*sourceWidth)/destWidth);
+			const unsigned char* s = line + (uint64_t)sx*4;
+			unsigned char* d = dline;
+			if (bMirror)
+				d += (uint64_t)(destWidth - x - 1)*dbpp;
+			else
+				d += (uint64_t)x*dbpp;
+			d[ir] = s[0];
+			d[ig] = s[1];
+			d[ib] = s[2];
+			if (dbpp == 4)
+				d[3] = s[3];
+		}
+	}
+
+	delete[] line;
+
+	return true;
+
+} // end hdr2rgba
+
+//---------------------------------------------------------
+// Function: hdr_line_to_rgba
+// Convert one line of 10 bit, 16 bit or floating point pixels to 8 bit RGBA
+void spoutCopy::hdr_line_to_rgba(const void* source, void* dest,
+	unsigned int width, DWORD dwFormat, bool bSRGB) const
+{
+	auto rgba = static_cast<unsigned char*>(dest);
+
+	if (dwFormat == 24) {
+		// R10G10B10A2_UNORM
+		unsigned int x = 0;
+		if (m_bSSE2) {
+			rgb10a2_to_rgba_sse2(source, dest, width & ~3u);
+			x = width & ~3u;
+		}
+		auto src = static_cast<const uint32_t*>(source);
+		for (; x < width; x++) {
+			const uint32_t p = src[x];
+			rgba[x*4 + 0] = (unsigned char)((p >> 2) & 0xFF);
+			rgba[x*4 + 1] = (unsigned char)((p >> 12) & 0xFF);
+			rgba[x*4 + 2] = (unsigned char)((p >> 22) & 0xFF);
+			rgba[x*4 + 3] = (unsigned char)((p >> 30)*85);
+		}
+	}
+	else if (dwFormat == 11) {
+		// R16G16B16A16_UNORM
+		unsigned int x = 0;
+		if (m_bSSE2) {
+			rgba16_to_rgba_sse2(source, dest, width & ~3u);
+			x = width & ~3u;
+		}
+		auto src = static_cast<const uint16_t*>(source);
+		for (; x < width*4; x++)
+			rgba[x] = (unsigned char)(src[x] >> 8);
+	}
+	else if (dwFormat == 10) {
+		// R16G16B16A16_FLOAT
+		// Colour may be sRGB encoded, alpha is linear
+		const unsigned char* colour = HalfTable(bSRGB);
+		const unsigned char* alpha = HalfTable(false);
+		auto src = static_cast<const uint16_t*>(source);
+		for (unsigned int x = 0; x < width; x++) {
+			rgba[0] = colour[src[0]];
+			rgba[1] = colour[src[1]];
+			rgba[2] = colour[src[2]];
+			rgba[3] = alpha[src[3]];
+			src += 4;
+			rgba += 4;
+		}
+	}
+
+} // end hdr_line_to_rgba
+
+//---------------------------------------------------------
+// Function: rgb10a2_to_rgba_sse2
+// SSE2 R10G10B10A2 to RGBA8, four pixels at a time.
+// Width must be a multiple of 4. Unaligned loads and stores.
+void spoutCopy::rgb10a2_to_rgba_sse2(const void* source, void* dest, unsigned int width) const
+{
+	auto src = static_cast<const __m128i*>(source);
+	auto dst = static_cast<__m128i*>(dest);
+	const __m128i mask = _mm_set1_epi32(0xFF);
+	const __m128i m85 = _mm_set1_epi32(85);
+
+	for (unsigned int x = 0; x < width; x += 4) {
+		const __m128i p = _mm_loadu_si128(src++);
+		const __m128i r = _mm_and_si128(_mm_srli_epi32(p, 2), mask);
+		const __m128i g = _mm_and_si128(_mm_srli_epi32(p, 12), mask);
+		const __m128i b = _mm_and_si128(_mm_srli_epi32(p, 22), mask);
+		// 2 bit alpha 0-3 > 0-255
+		const __m128i a = _mm_mullo_epi16(_mm_srli_epi32(p, 30), m85);
+		__m128i out = _mm_or_si128(r, _mm_slli_epi32(g, 8));
+		out = _mm_or_si128(out, _mm_slli_epi32(b, 16));
+		out = _mm_or_si128(out, _mm_slli_epi32(a, 24));
+		_mm_storeu_si128(dst++, out);
+	}
+}
+
+//---------------------------------------------------------
+// Function: rgba16_to_rgba_sse2
+// SSE2 R16G16B16A16_UNORM to RGBA8, four pixels at a time.
+// Width must be a multiple of 4. Unaligned loads and stores.
+void spoutCopy::rgba16_to_rgba_sse2(const void* source, void* dest, unsigned int width) const
+{
+	auto src = static_cast<const __m128i*>(source);
+	auto dst = static_cast<__m128i*>(dest);
+
+	for (unsigned int x = 0; x < width; x += 4) {
+		// Two pixels in each register
+		const __m128i p1 = _mm_srli_epi16(_mm_loadu_si128(src), 8);
+		const __m128i p2 = _mm_srli_epi16(_mm_loadu_si128(src + 1), 8);
+		_mm_storeu_si128(dst++, _mm_packus_epi16(p1, p2));
+		src += 2;
+	}
+}
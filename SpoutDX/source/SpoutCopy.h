@@ -76,6 +76,10 @@ class SPOUT_DLLEXP spoutCopy {
 		// SSE2 version of memcpy
 		void memcpy_sse2(void* dst, const void* src, size_t size) const;
 
+		// Linear blend of two pixel buffers of the same size and format
+		void BlendPixels(const void* source1, const void* source2, void* dest,
+			size_t size, unsigned int weight) const;
+
 		//
 		// RGBA <> RGBA
 		//
@@ -203,6 +207,20 @@ class SPOUT_DLLEXP spoutCopy {
 		// Copy BGRA to BGR
 		void bgra2bgr (const void* bgra_source, void *bgr_dest,  unsigned int width, unsigned int height, bool bInvert = false) const;
 
+		//
+		// 10 bit, 16 bit and floating point textures
+		//
+
+		// Convert R10G10B10A2 (24), R16G16B16A16_UNORM (11) or R16G16B16A16_FLOAT (10)
+		// texture data to 8 bit GL_RGBA, GL_BGRA_EXT, GL_RGB or GL_BGR_EXT pixels
+		// with resampling if the source and destination sizes are different.
+		// bSRGB - encode linear floating point values as sRGB
+		bool hdr2rgba(const void* source, void* dest,
+			unsigned int sourceWidth, unsigned int sourceHeight, unsigned int sourcePitch,
+			unsigned int destWidth, unsigned int destHeight,
+			DWORD dwFormat, GLenum glFormat,
+			bool bInvert = false, bool bMirror = false, bool bSRGB = true) const;
+
 		// SSE capability
 
 		void GetSSE(bool &bSSE2, bool &bSSE3, bool &bSSSE3);
@@ -218,6 +236,11 @@ class SPOUT_DLLEXP spoutCopy {
 		void rgba_bgra_sse2(const void *rgba_source, void *bgra_dest, unsigned int width, unsigned int height, bool bInvert = false) const;
 		void rgba_bgra_sse3(const void *rgba_source, void *bgra_dest, unsigned int width, unsigned int height, bool bInvert = false) const;
 
+		// Single line conversion of 10 bit, 16 bit and floating point pixels to 8 bit RGBA
+		void hdr_line_to_rgba(const void* source, void* dest, unsigned int width, DWORD dwFormat, bool bSRGB) const;
+		void rgb10a2_to_rgba_sse2(const void* source, void* dest, unsigned int width) const;
+		void rgba16_to_rgba_sse2(const void* source, void* dest, unsigned int width) const;
+
 };
 
 #endif
@@ -160,6 +160,36 @@
 //					  convert to a string of 8 characters without new line
 //		28.07.24	- Change to #if __has_include("SpoutCommon.h") in Spout.h
 //		22.10.24	- SelectSender - remove message string line feed for SpoutPanel
+//		18.10.26	- ReceiveImage - record whether the pixel buffer was written.
+//					  Add IsFrameUnchanged so that the caller can re-use the previous
+//					  frame instead of delivering an untouched buffer.
+//					- Add WaitNewFrame for event driven receive, and CanWaitNewFrame
+//					- ReceiveSenderData - use sendernames.CheckSenderInfo to keep the
+//					  sender map open and read it again only if the information changes
+//					- Add a receiving device pool keyed by adapter LUID.
+//					  CheckSenderTexture binds to a retained device for the sender adapter
+//					  instead of closing and re-creating the class device.
+//					  GetSenderAdapter - create test devices without changing the class context
+//					- ReadPixelData - convert 10 bit, 16 bit and floating point textures
+//					  using spoutcopy.hdr2rgba. Add SetSRGB/GetSRGB.
+//					- GetSenderList - use the sender names snapshot
+//					- SendTexture/SendImage - update the sender registry heartbeat
+//					- Add GetSenderChanges
+//					- Memory buffer - add a binary header after the data so that the size
+//					  is read once, readers do not lock, and a writer can replace the
+//					  buffer with a larger one. The decimal size is retained.
+//					- Add GetMemoryView, CheckMemoryView
+//					- Add frame metadata functions
+//					  CreateFrameMetadata, WriteFrameMetadata, ReadFrameMetadata,
+//					  IsFrameMetadataNew
+//					- Add GetSenderFrameStats, SetSenderFpsWindow
+//					- Add SetAccessTimeout, GetAccessStats
+//					- Send functions wait for lock-step receivers to take the last frame.
+//					  Add SetLockStep, SetReceiverWait, GetReceiverLag
+//					- Add GetImageFrame, GetImageTime for the sender frame
+//					  of the pixels received by ReceiveImage
+//					- ReleaseReceiver - keep the staging textures in the adapter device pool
+//					  entry of the device so that they are re-used when it is bound again
 //
 // ====================================================================================
 /*
@@ -207,6 +237,8 @@ spoutDX::spoutDX()
 	m_pStaging[1] = nullptr;
 	m_Index = 0;
 	m_NextIndex = 0;
+	m_StagingFrame[0] = m_StagingFrame[1] = 0;
+	m_StagingTime[0] = m_StagingTime[1] = 0;
 
 	m_pSharedTexture = nullptr;
 	m_dxShareHandle = nullptr;
@@ -216,14 +248,22 @@ spoutDX::spoutDX()
 	m_Width = 0;
 	m_Height = 0;
 	m_bUpdated = false;
+	m_bFrameUnchanged = false;
 	m_bConnected = false;
 	m_bSpoutInitialized = false;
 	m_bSpoutPanelOpened = false;
 	m_bSpoutPanelActive = false;
 	m_bClassDevice = false;
 	m_bMirror = false;
+	m_pMemoryMap = nullptr;
+	m_MemoryCapacity = 0;
+	m_MemoryMapCapacity = 0;
+	m_MemoryMapNumber = 0;
+	m_MetadataFrame = 0;
 	m_bSwapRB = false;
+	m_bSRGB = true;
 	m_bAdapt = false; // Receiver switch to the sender's graphics adapter
+	m_pDevicePool = new std::vector<spoutAdapterDevice>();
 	m_bMemoryShare = GetMemoryShareMode(); // 2.006 memoryshare mode
 
 	ZeroMemory(&m_SenderInfo, sizeof(SharedTextureInfo));
@@ -245,7 +285,10 @@ spoutDX::~spoutDX()
 	}
 
 	CloseDirectX11();
-	memorybuffer.Close();
+	CloseMemoryBuffer();
+	CloseFrameMetadata();
+
+	delete m_pDevicePool;
 
 }
 
@@ -323,10 +366,16 @@ void spoutDX::CloseDirectX11()
 	m_pStaging[1] = nullptr;
 	m_Index = 0;
 	m_NextIndex = 0;
+	m_StagingFrame[0] = m_StagingFrame[1] = 0;
+	m_StagingTime[0] = m_StagingTime[1] = 0;
 	
 	// Flush now to avoid deferred object destruction
 	if (m_pImmediateContext) m_pImmediateContext->Flush();
 
+	// Release devices created for other adapters
+	// and restore the class device if one was in use
+	ReleaseDevicePool();
+
 	if (m_pd3dDevice) {
 		if (m_bClassDevice) {
 			// A device was created using the SpoutDirectX class
@@ -442,8 +491,9 @@ void spoutDX::ReleaseSender()
 	m_SenderName[0] = 0;
 	m_bSpoutInitialized = false;
 
-	// Close shared memory buffer if used
-	memorybuffer.Close();
+	// Close shared memory buffer and frame metadata if used
+	CloseMemoryBuffer();
+	CloseFrameMetadata();
 
 }
 
@@ -521,6 +571,9 @@ bool spoutDX::SendTexture(ID3D11Texture2D* pTexture)
 	if (!CheckSender(desc.Width, desc.Height, (DWORD)desc.Format))
 		return false;
 
+	// Wait for lock-step receivers to take the last frame
+	frame.WaitReceivers();
+
 	// Check the sender mutex for access the shared texture
 	if (frame.CheckTextureAccess(m_pSharedTexture)) {
 		// Copy the application texture to the sender's shared texture
@@ -531,6 +584,8 @@ bool spoutDX::SendTexture(ID3D11Texture2D* pTexture)
 		frame.SetNewFrame();
 		// Allow access to the shared texture
 		frame.AllowTextureAccess(m_pSharedTexture);
+		// Registry heartbeat for checking the sender list
+		sendernames.UpdateHeartbeat();
 	}
 
 	return true;
@@ -583,6 +638,9 @@ bool spoutDX::SendTexture(ID3D11Texture2D* pTexture,
 		return false;
 	}
 
+	// Wait for lock-step receivers to take the last frame
+	frame.WaitReceivers();
+
 	// Check the sender mutex for access the shared texture
 	if (frame.CheckTextureAccess(m_pSharedTexture)) {
 		// Copy the texture region to the sender's shared texture
@@ -593,6 +651,8 @@ bool spoutDX::SendTexture(ID3D11Texture2D* pTexture,
 		frame.SetNewFrame();
 		// Allow access to the shared texture
 		frame.AllowTextureAccess(m_pSharedTexture);
+		// Registry heartbeat for checking the sender list
+		sendernames.UpdateHeartbeat();
 	}
 
 	return true;
@@ -618,6 +678,9 @@ bool spoutDX::SendImage(const unsigned char * pData, unsigned int width, unsigne
 	if(pitch > 0)
 		rowpitch = pitch;
 
+	// Wait for lock-step receivers to take the last frame
+	frame.WaitReceivers();
+
 	// Check the sender mutex for access the shared texture
 	if (frame.CheckTextureAccess(m_pSharedTexture)) {
 		// Update the shared texture resource with the pixel buffer
@@ -630,6 +693,8 @@ bool spoutDX::SendImage(const unsigned char * pData, unsigned int width, unsigne
 		frame.SetNewFrame();
 		// Allow access to the shared texture
 		frame.AllowTextureAccess(m_pSharedTexture);
+		// Registry heartbeat for checking the sender list
+		sendernames.UpdateHeartbeat();
 	}
 
 	return true;
@@ -750,12 +815,17 @@ void spoutDX::ReleaseReceiver()
 	m_pTexture = nullptr;
 	
 	// Staging textures for ReceiveImage
-	if (m_pStaging[0]) spoutdx.ReleaseDX11Texture(m_pd3dDevice, m_pStaging[0]);
-	if (m_pStaging[1]) spoutdx.ReleaseDX11Texture(m_pd3dDevice, m_pStaging[1]);
-	m_pStaging[0] = nullptr;
-	m_pStaging[1] = nullptr;
+	// Retained with the device if it is in the adapter device pool
+	if (!SaveStagingTextures()) {
+		if (m_pStaging[0]) spoutdx.ReleaseDX11Texture(m_pd3dDevice, m_pStaging[0]);
+		if (m_pStaging[1]) spoutdx.ReleaseDX11Texture(m_pd3dDevice, m_pStaging[1]);
+		m_pStaging[0] = nullptr;
+		m_pStaging[1] = nullptr;
+	}
 	m_Index = 0;
 	m_NextIndex = 0;
+	m_StagingFrame[0] = m_StagingFrame[1] = 0;
+	m_StagingTime[0] = m_StagingTime[1] = 0;
 
 	// Flush now to avoid deferred object destruction
 	if (m_pImmediateContext) m_pImmediateContext->Flush();
@@ -764,8 +834,12 @@ void spoutDX::ReleaseReceiver()
 	frame.CloseAccessMutex();
 	frame.CleanupFrameCount();
 
-	// Close shared memory buffer if used
-	memorybuffer.Close();
+	// Close the sender information map
+	sendernames.CloseSenderInfo();
+
+	// Close shared memory buffer and frame metadata if used
+	CloseMemoryBuffer();
+	CloseFrameMetadata();
 
 	// Zero width and height so that they are reset when a sender is found
 	m_Width = 0;
@@ -920,6 +994,9 @@ bool spoutDX::ReceiveTexture(ID3D11Texture2D** ppTexture)
 bool spoutDX::ReceiveImage(unsigned char * pixels,
 	unsigned int width, unsigned int height, bool bRGB, bool bInvert)
 {
+	// The pixel buffer is unchanged unless a new frame is read below
+	m_bFrameUnchanged = true;
+
 	// Return if flagged for update
 	// The update flag is reset when the receiving application calls IsUpdated()
 	if (m_bUpdated)
@@ -965,8 +1042,12 @@ bool spoutDX::ReceiveImage(unsigned char * pixels,
 				m_NextIndex = (m_Index + 1) % 2;
 				// Copy from the sender's shared texture to the first staging texture
 				m_pImmediateContext->CopyResource(m_pStaging[m_Index], m_pSharedTexture);
+				// The sender frame in the staging texture, read by the next call
+				m_StagingFrame[m_Index] = frame.GetSenderFrame();
+				m_StagingTime[m_Index] = frame.GetSenderFrameTime();
 				// Map and read from the second while the first is occupied
-				ReadPixelData(m_pStaging[m_NextIndex], pixels, width, height, bRGB, bInvert, m_bSwapRB);
+				if (ReadPixelData(m_pStaging[m_NextIndex], pixels, width, height, bRGB, bInvert, m_bSwapRB))
+					m_bFrameUnchanged = false;
 			}
 			// Allow access to the shared texture
 			frame.AllowTextureAccess(m_pSharedTexture);
@@ -1015,6 +1096,9 @@ bool spoutDX::ReadTexurePixels(ID3D11Texture2D* pTexture, unsigned char* pixels)
 
 	// Copy from the texture to the first staging texture
 	m_pImmediateContext->CopyResource(m_pStaging[m_Index], pTexture);
+	// Not a sender frame
+	m_StagingFrame[m_Index] = 0;
+	m_StagingTime[m_Index] = 0;
 
 	// Map and read from the second while the first is occupied
 	ReadPixelData(m_pStaging[m_NextIndex], pixels, width, height, false, false, m_bSwapRB);
@@ -1123,6 +1207,20 @@ bool spoutDX::IsFrameNew()
 	return frame.IsFrameNew();
 }
 
+//---------------------------------------------------------
+// Function: IsFrameUnchanged
+// Query whether the last ReceiveImage wrote the pixel buffer
+//
+//   Returns true if ReceiveImage succeeded but the buffer was not written,
+//   either because the sender has not produced a new frame, the texture
+//   could not be accessed or the sender has changed.
+//   The buffer then still holds whatever it contained before the call,
+//   so the application should re-use the previous frame.
+bool spoutDX::IsFrameUnchanged()
+{
+	return m_bFrameUnchanged;
+}
+
 //---------------------------------------------------------
 // Function: GetSenderTexture()
 // Received class texture
@@ -1204,6 +1302,70 @@ double spoutDX::GetSenderFps()
 	return frame.GetSenderFps();
 }
 
+//---------------------------------------------------------
+// Function: GetSenderFrameStats
+// Get sender frame rate statistics.
+// Mean fps, median interval, jitter, dropped and missed frames
+// over the frame interval window. See spoutFrameCount::GetFrameStats.
+bool spoutDX::GetSenderFrameStats(SpoutFrameStats& stats)
+{
+	return frame.GetFrameStats(stats);
+}
+
+//---------------------------------------------------------
+// Function: SetSenderFpsWindow
+// Number of frame intervals for sender frame rate statistics
+void spoutDX::SetSenderFpsWindow(int frames)
+{
+	frame.SetFpsWindow(frames);
+}
+
+//---------------------------------------------------------
+// Function: SetAccessTimeout
+// Time to wait for the sender texture (msec).
+// With zero, a receive function does not wait if the sender
+// holds the texture, and IsFrameUnchanged returns true.
+void spoutDX::SetAccessTimeout(DWORD dwTimeout)
+{
+	frame.SetAccessTimeout(dwTimeout);
+}
+
+//---------------------------------------------------------
+// Function: GetAccessStats
+// Sender texture access waits for the connection.
+// See spoutFrameCount::GetAccessStats.
+bool spoutDX::GetAccessStats(SpoutAccessStats& stats)
+{
+	return frame.GetAccessStats(stats);
+}
+
+//---------------------------------------------------------
+// Function: SetLockStep
+// Receiver - the sender waits for this receiver to take each frame
+// if the sender has set a wait time with SetReceiverWait.
+void spoutDX::SetLockStep(bool bLockStep)
+{
+	frame.SetLockStep(bLockStep);
+}
+
+//---------------------------------------------------------
+// Function: SetReceiverWait
+// Sender - time to wait for lock-step receivers
+// before each frame (msec, 0 - do not wait)
+void spoutDX::SetReceiverWait(DWORD dwTimeout)
+{
+	frame.SetReceiverWait(dwTimeout);
+}
+
+//---------------------------------------------------------
+// Function: GetReceiverLag
+// Frames behind the sender for each receiver.
+// Returns the number of receivers.
+int spoutDX::GetReceiverLag(long* lag, int maxreceivers)
+{
+	return frame.GetReceiverLag(lag, maxreceivers);
+}
+
 //---------------------------------------------------------
 // Function: GetSenderFrame
 // Get sender frame number
@@ -1212,6 +1374,28 @@ long spoutDX::GetSenderFrame()
 	return frame.GetSenderFrame();
 }
 
+//---------------------------------------------------------
+// Function: GetImageFrame
+// Sender frame number of the pixels received by ReceiveImage.
+//
+// ReceiveImage reads the staging texture copied by the previous call,
+// so the pixels are one frame behind GetSenderFrame.
+// Zero if no frame has been read.
+long spoutDX::GetImageFrame()
+{
+	return m_StagingFrame[m_NextIndex];
+}
+
+//---------------------------------------------------------
+// Function: GetImageTime
+// Sender clock time of the pixels received by ReceiveImage.
+//
+// Zero if the sender does not publish the frame control block.
+LONG64 spoutDX::GetImageTime()
+{
+	return m_StagingTime[m_NextIndex];
+}
+
 
 //---------------------------------------------------------
 // COMMON
@@ -1271,6 +1455,33 @@ bool spoutDX::WaitFrameSync(const char *SenderName, DWORD dwTimeout)
 	return frame.WaitFrameSync(SenderName, dwTimeout);
 }
 
+// -----------------------------------------------
+// Function: WaitNewFrame
+// Wait for the connected sender to produce a new frame.
+//   Tests the sender frame count until it changes.
+//   Returns false if the timeout elapsed without a new frame.
+//   Returns true if not connected, so that ReceiveImage or
+//   ReceiveTexture can be called to connect to a sender.
+bool spoutDX::WaitNewFrame(DWORD dwTimeout)
+{
+	if (!m_bSpoutInitialized || !m_SenderName[0])
+		return true;
+	return frame.WaitNewFrame(m_SenderName, dwTimeout);
+}
+
+// -----------------------------------------------
+// Function: CanWaitNewFrame
+// The connected sender frame count can be waited for.
+//   False if not connected or frame counting is not available.
+//   WaitNewFrame then returns immediately, so the application
+//   should hold its own frame rate.
+bool spoutDX::CanWaitNewFrame()
+{
+	if (!m_bSpoutInitialized || !m_SenderName[0])
+		return false;
+	return frame.CanWaitNewFrame();
+}
+
 
 //---------------------------------------------------------
 // SenderNames
@@ -1302,13 +1513,11 @@ bool spoutDX::GetSender(int index, char* sendername, int sendernameMaxSize)
 std::vector<std::string> spoutDX::GetSenderList()
 {
 	std::vector<std::string> list;
-	int nSenders = GetSenderCount();
-	if (nSenders > 0) {
-		char sendername[256]{};
-		for (int i=0; i<nSenders; i++) {
-			if (GetSender(i, sendername))
-				list.push_back(sendername);
-		}
+	// GetSenderCount removes senders that no longer exist
+	if (GetSenderCount() > 0) {
+		const std::shared_ptr<const SpoutSenderSnapshot> snapshot = sendernames.GetSenderSnapshot();
+		if (snapshot)
+			list = snapshot->names;
 	}
 	return list;
 }
@@ -1321,6 +1530,16 @@ int spoutDX::GetSenderIndex(const char* sendername)
 	return sendernames.GetSenderIndex(sendername);
 }
 
+//---------------------------------------------------------
+// Function: GetSenderChanges
+// Count of sender changes. Incremented when a sender is created,
+// released, changes size or format, or is made active.
+// A receiver can test for a change instead of looking for senders.
+long spoutDX::GetSenderChanges()
+{
+	return sendernames.GetChangeCount();
+}
+
 //---------------------------------------------------------
 // Function: GetSenderInfo
 // Sender information
@@ -1483,9 +1702,6 @@ int spoutDX::GetSenderAdapter(const char* sendername, char* adaptername, int max
 	ID3D11DeviceContext* pContext = nullptr;
 	IDXGIAdapter* pAdapter = nullptr;
 
-	// Get the current device adapter pointer (could be null default)
-	IDXGIAdapter* pCurrentAdapter = spoutdx.GetAdapterPointer();
-
 	SpoutLogNotice("spoutDX::GetSenderAdapter - testing for sender adapter (%s)", sendername);
 
 	SharedTextureInfo info={};
@@ -1495,10 +1711,9 @@ int spoutDX::GetSenderAdapter(const char* sendername, char* adaptername, int max
 			pAdapter = spoutdx.GetAdapterPointer(i);
 			if (pAdapter) {
 				SpoutLogNotice("   testing adapter %d", i);
-				// Set the adapter pointer for CreateDX11device to use temporarily
-				spoutdx.SetAdapterPointer(pAdapter);
 				// Create a dummy device using this adapter
-				pDummyDevice = spoutdx.CreateDX11device();
+				// without changing the class device context
+				pDummyDevice = CreateAdapterDevice(pAdapter, &pContext);
 				if (pDummyDevice) {
 					// Try to open the share handle with the device created from the adapter
 					if (spoutdx.OpenDX11shareHandle(pDummyDevice, &pSharedTexture, LongToHandle((long)info.shareHandle))) {
@@ -1508,14 +1723,15 @@ int spoutDX::GetSenderAdapter(const char* sendername, char* adaptername, int max
 						// Return the adapter name
 						if(adaptername)
 							spoutdx.GetAdapterName(i, adaptername, maxchars);
-						pDummyDevice->GetImmediateContext(&pContext);
-						if (pContext) pContext->Flush();
+						pSharedTexture->Release();
+						pContext->Flush();
+						pContext->Release();
 						pDummyDevice->Release();
 						pAdapter->Release();
 						break;
 					}
-					pDummyDevice->GetImmediateContext(&pContext);
-					if (pContext) pContext->Flush();
+					pContext->Flush();
+					pContext->Release();
 					pDummyDevice->Release();
 				}
 				pAdapter->Release();
@@ -1523,9 +1739,6 @@ int spoutDX::GetSenderAdapter(const char* sendername, char* adaptername, int max
 		}
 	}
 
-	// Set the SpoutDirectX class adapter pointer back to what it was
-	spoutdx.SetAdapterPointer(pCurrentAdapter);
-
 	// Return the sender adapter index
 	return senderadapter;
 
@@ -1711,6 +1924,69 @@ bool spoutDX::IsApplicationPath(const char* path)
 //   a receiver should signal that it is ready to read another. 
 //
 
+//
+// Memory buffer layout
+//
+// "<sender>_map"
+//   16 bytes   : bytes available for data as decimal digits (read by earlier versions)
+//   capacity   : data
+//   16 bytes   : allows for a null terminator
+//   SpoutMemoryHeader at the next 16 byte boundary
+//
+// "<sender>_map_<n>" replaces it if a writer needs a larger buffer
+//   SpoutMemoryHeader
+//   capacity   : data
+//   16 bytes   : allows for a null terminator
+//
+// The header records the data length and a sequence count for reading
+// without locking. Earlier writers do not add the header and the map
+// is locked for every read.
+//
+
+// Offset of the header of a "<sender>_map" memory map
+static int MemoryHeaderOffset(int capacity)
+{
+	return (32 + capacity + 15) & ~15;
+}
+
+// Write data and update the header sequence and length.
+// The map must be locked.
+static void WriteMemoryData(char* pData, SpoutMemoryHeader* header, const char* data, int length)
+{
+	int nbytes = length;
+	if (nbytes > (int)header->capacity)
+		nbytes = (int)header->capacity;
+	InterlockedIncrement(&header->sequence); // Odd while writing
+	memcpy(reinterpret_cast<void*>(pData), reinterpret_cast<const void*>(data), nbytes);
+	*(pData + nbytes) = 0; // The map is created larger to allow for it
+	header->used = (uint32_t)nbytes;
+	InterlockedIncrement(&header->sequence);
+}
+
+// Copy data without locking. Returns -1 if a consistent copy was not made.
+static int ReadMemoryData(const SpoutMemoryHeader* header, const char* pData, char* data, int maxlength)
+{
+	for (int i = 0; i < SPOUT_SEQUENCE_RETRIES; i++) {
+		const LONG sequence = header->sequence;
+		if (sequence & 1) {
+			YieldProcessor();
+			continue;
+		}
+		MemoryBarrier();
+		int nbytes = (int)header->used;
+		if (nbytes > (int)header->capacity)
+			nbytes = (int)header->capacity;
+		if (nbytes > maxlength)
+			nbytes = maxlength;
+		if (nbytes > 0)
+			memcpy(reinterpret_cast<void*>(data), reinterpret_cast<const void*>(pData), nbytes);
+		MemoryBarrier();
+		if (header->sequence == sequence)
+			return nbytes;
+	}
+	return -1;
+}
+
 //---------------------------------------------------------
 // Function: WriteMemoryBuffer
 // Write buffer to sender shared memory.
@@ -1718,9 +1994,9 @@ bool spoutDX::IsApplicationPath(const char* path)
 //    If shared memory has not been created in advance, it will be
 //    created on the first call to this function at the length specified.
 //
-//    This is acceptable if the data to send is fixed in length.
-//    Otherwise the shared memory should be created in advance of sufficient
-//    size to contain the maximum length expected (see CreateMemoryBuffer).
+//    If the length is larger than the buffer, a larger buffer is created
+//    and receivers change to it. Earlier receivers continue to read the
+//    original buffer which receives the data up to it's size.
 //
 //    The map is closed when the sender is released.
 //
@@ -1735,48 +2011,45 @@ bool spoutDX::WriteMemoryBuffer(const char *name, const char* data, int length)
 		return false;
 	}
 
-	if (!data) {
+	if (!data || length < 0) {
 		SpoutLogError("SpoutSharedMemory::WriteMemoryBuffer - no data");
 		return false;
 	}
 
 	// Create a shared memory map for the buffer if it does not exist yet
 	if (memorybuffer.Size() == 0) {
-		// Create a name for the map from the sender name
-		std::string namestring = name;
-		namestring += "_map";
-		// The first 16 bytes are reserved for the memory map size. Make the map larger to compensate. 
-		if (!memorybuffer.Create(namestring.c_str(), length + 16)) {
-			SpoutLogError("SpoutSharedMemory::WriteMemoryBuffer - could not create shared memory");
-			return false;
-		}
-		char* pBuffer = memorybuffer.Lock();
-		if (!pBuffer) {
-			SpoutLogError("SpoutSharedMemory::WriteMemoryBuffer - no buffer lock");
+		if (!CreateMemoryBuffer(name, length))
 			return false;
+	}
+
+	// Replace with a larger buffer if necessary
+	const int capacity = m_pMemoryMap ? m_MemoryMapCapacity : m_MemoryCapacity;
+	if (length > capacity) {
+		if (!GrowMemoryBuffer(name, length)) {
+			SpoutLogWarning("SpoutSharedMemory::WriteMemoryBuffer - could not create larger buffer");
 		}
-		// Convert the map size to decimal digit chars directly to shared memory
-		_itoa_s(length, reinterpret_cast<char *>(pBuffer), 16, 10);
-		memorybuffer.Unlock();
-		SpoutLogNotice("SpoutSharedMemory::WriteMemoryBuffer - created memory buffer %d bytes", length);
 	}
 
+	// Write user data to the original buffer for earlier receivers
 	char* pBuffer = memorybuffer.Lock();
 	if (!pBuffer) {
 		SpoutLogError("SpoutSharedMemory::WriteMemoryBuffer - no buffer lock");
 		return false;
 	}
-
-	// Write user data to shared memory (skip the map size)
-	memcpy(reinterpret_cast<void *>(pBuffer + 16), reinterpret_cast<const void *>(data), length);
-
-	// Terminate the shared memory data with a null.
-	// The map is created larger in advance to allow for it.
-	if (memorybuffer.Size() > (16 + length))
-		*(pBuffer + 16 + length) = 0;
-
+	WriteMemoryData(pBuffer + 16, (SpoutMemoryHeader*)(pBuffer + MemoryHeaderOffset(m_MemoryCapacity)), data, length);
 	memorybuffer.Unlock();
 
+	// And to a larger buffer that replaces it
+	if (m_pMemoryMap) {
+		pBuffer = m_pMemoryMap->Lock();
+		if (!pBuffer) {
+			SpoutLogError("SpoutSharedMemory::WriteMemoryBuffer - no buffer lock");
+			return false;
+		}
+		WriteMemoryData(pBuffer + sizeof(SpoutMemoryHeader), (SpoutMemoryHeader*)pBuffer, data, length);
+		m_pMemoryMap->Unlock();
+	}
+
 	return true;
 }
 
@@ -1786,6 +2059,8 @@ bool spoutDX::WriteMemoryBuffer(const char *name, const char* data, int length)
 //
 //    Open a sender memory map and retain the handle.
 //    The map is closed when the receiver is released.
+//    Returns the number of bytes written by the sender
+//    or the buffer size for earlier senders.
 int spoutDX::ReadMemoryBuffer(const char* name, char* data, int maxlength)
 {
 	// Quit if 2.006 memory share mode
@@ -1803,29 +2078,37 @@ int spoutDX::ReadMemoryBuffer(const char* name, char* data, int maxlength)
 	}
 
 	// Open a shared memory map for the buffer if it not already
-	if (!memorybuffer.Name()) {
-		// Create a name for the map from the sender name
-		std::string namestring = name;
-		namestring += "_map";
-		// Open the shared memory. This also creates a mutex
-		// for the reader to lock and unlock the map for reads.
-		if (!memorybuffer.Open(namestring.c_str())) {
-			return 0;
-		}
-		SpoutLogNotice("SpoutSharedMemory::ReadMemoryBuffer - opened sender memory map [%s]", memorybuffer.Name());
+	if (!OpenMemoryBuffer(name))
+		return 0;
+
+	// Read without locking if the sender has written the header
+	const char* pData = nullptr;
+	const SpoutMemoryHeader* header = FollowMemoryBuffer(name, &pData);
+	if (header) {
+		const int nbytes = ReadMemoryData(header, pData, data, maxlength);
+		if (nbytes >= 0)
+			return nbytes;
 	}
 
-	char* pBuffer = memorybuffer.Lock();
+	// Earlier sender or the sequenced read failed
+	SpoutSharedMemory* pMap = (header && m_pMemoryMap) ? m_pMemoryMap : &memorybuffer;
+	char* pBuffer = pMap->Lock();
 	if (!pBuffer) {
 		SpoutLogError("SpoutSharedMemory::ReadMemoryBuffer - no buffer lock");
 		return 0;
 	}
 
-	// The memory map includes it's size, saved as the first 16 bytes
-	*(pBuffer + 15) = 0; // End for atoi
-
-	// Number of bytes available for data transfer
-	int nbytes = atoi(reinterpret_cast<char *>(pBuffer));
+	int nbytes = 0;
+	if (header) {
+		nbytes = (int)header->used;
+		if (nbytes > (int)header->capacity)
+			nbytes = (int)header->capacity;
+	}
+	else {
+		// Number of bytes available for data transfer
+		nbytes = m_MemoryCapacity;
+		pData = pBuffer + 16;
+	}
 
 	// Reduce if the user buffer max length is less
 	if (maxlength < nbytes)
@@ -1833,10 +2116,10 @@ int spoutDX::ReadMemoryBuffer(const char* name, char* data, int maxlength)
 
 	// Copy bytes from shared memory to the user buffer
 	if (nbytes > 0)
-		memcpy(reinterpret_cast<void *>(data), reinterpret_cast<const void *>(pBuffer + 16), nbytes);
+		memcpy(reinterpret_cast<void *>(data), reinterpret_cast<const void *>(pData), nbytes);
 
 	// Done with the shared memory buffer pointer
-	memorybuffer.Unlock();
+	pMap->Unlock();
 
 	return nbytes;
 
@@ -1872,13 +2155,20 @@ bool spoutDX::CreateMemoryBuffer(const char *name, int length)
 
 	// The first 16 bytes are reserved to record the number of bytes available
 	// for data transfer. Make the map 16 bytes larger to compensate. 
-	// Add another 16 bytes to allow for a null terminator.
-	// (Use multiples of 16 for alignment to allow for SSE copy : TODO).
-	if (!memorybuffer.Create(namestring.c_str(), length + 32)) {
+	// Add another 16 bytes to allow for a null terminator
+	// and the header that follows (see Memory buffer layout).
+	if (!memorybuffer.Create(namestring.c_str(), MemoryHeaderOffset(length) + (int)sizeof(SpoutMemoryHeader))) {
 		SpoutLogError("spoutGL::CreateMemoryBuffer - could not create shared memory");
 		return false;
 	}
 
+	// A map that remains open by a receiver has the size it was created with
+	if (memorybuffer.Size() < MemoryHeaderOffset(length) + (int)sizeof(SpoutMemoryHeader)) {
+		SpoutLogError("spoutDX::CreateMemoryBuffer - existing shared memory is too small");
+		memorybuffer.Close();
+		return false;
+	}
+
 	// The length requested is the number of bytes to be
 	// available for data transfer (map data size).
 	char* pBuffer = memorybuffer.Lock();
@@ -1891,8 +2181,18 @@ bool spoutDX::CreateMemoryBuffer(const char *name, int length)
 	// directly to the first 16 bytes of the shared memory.
 	_itoa_s(length, reinterpret_cast<char *>(pBuffer), 16, 10);
 
+	// Binary header for this version
+	SpoutMemoryHeader* header = (SpoutMemoryHeader*)(pBuffer + MemoryHeaderOffset(length));
+	header->id = SPOUT_MEMORY_ID;
+	header->version = SPOUT_MEMORY_VERSION;
+	header->capacity = (uint32_t)length;
+	header->used = 0;
+	header->next = 0;
+
 	memorybuffer.Unlock();
 
+	m_MemoryCapacity = length;
+
 	SpoutLogNotice("spoutDXL::CreateMemoryBuffer - created memory buffer %d bytes", length);
 
 	return true;
@@ -1915,7 +2215,7 @@ bool spoutDX::DeleteMemoryBuffer()
 		return false;
 	}
 
-	memorybuffer.Close();
+	CloseMemoryBuffer();
 
 	return true;
 
@@ -1931,42 +2231,478 @@ int spoutDX::GetMemoryBufferSize(const char *name)
 	if (!m_bSpoutInitialized)
 		return 0;
 
-	// A writer has created the map and recorded the data length in the first 16 bytes.
-	// Another 16 bytes is added to allow for a terminating NULL. (See CreateMemoryBuffer)
-	// The remaining length is the number of bytes available for data transfer.
-	if (memorybuffer.Size() > 32) {
-		return memorybuffer.Size() - 32;
+	// A reader must open the map to get the size
+	if (!OpenMemoryBuffer(name))
+		return 0;
+
+	// The size of a larger buffer that replaces it
+	const char* pData = nullptr;
+	const SpoutMemoryHeader* header = FollowMemoryBuffer(name, &pData);
+	if (header)
+		return (int)header->capacity;
+
+	// The number of bytes of the memory map available for data transfer
+	return m_MemoryCapacity;
+
+}
+
+//---------------------------------------------------------
+// Function: GetMemoryView
+// View sender shared memory data without copying.
+//
+//    Returns a pointer to the data in the memory map, the number of
+//    bytes written by the sender and the write sequence. The data can be
+//    used in place and CheckMemoryView called when done to find whether
+//    the sender has written to it in the meantime.
+//
+//    The view remains valid until the next GetMemoryView or ReadMemoryBuffer
+//    which may change to a larger buffer, or until the receiver is released.
+//
+//    Returns false if the sender is writing or does not support views.
+//    ReadMemoryBuffer can then be used.
+bool spoutDX::GetMemoryView(const char* name, spoutMemoryView& view)
+{
+	view.data = nullptr;
+	view.length = 0;
+	view.sequence = 0;
+	view.pHeader = nullptr;
+
+	// Quit if 2.006 memory share mode
+	if (m_bMemoryShare)
+		return false;
+
+	if (!OpenMemoryBuffer(name))
+		return false;
+
+	// Earlier senders do not record a write sequence
+	const char* pData = nullptr;
+	const SpoutMemoryHeader* header = FollowMemoryBuffer(name, &pData);
+	if (!header)
+		return false;
+
+	for (int i = 0; i < SPOUT_SEQUENCE_RETRIES; i++) {
+		const LONG sequence = header->sequence;
+		if (sequence & 1) {
+			YieldProcessor();
+			continue;
+		}
+		MemoryBarrier();
+		int nbytes = (int)header->used;
+		if (nbytes > (int)header->capacity)
+			nbytes = (int)header->capacity;
+		MemoryBarrier();
+		if (header->sequence == sequence) {
+			view.data = pData;
+			view.length = nbytes;
+			view.sequence = sequence;
+			view.pHeader = header;
+			return true;
+		}
 	}
 
-	// A reader must read the map to get the size
-	// Open a shared memory map for the buffer if it not already
-	if (!memorybuffer.Name()) {
-		// Create a name for the map
-		std::string namestring = name;
-		namestring += "_map";
-		// Open the shared memory map.
-		// This also creates a mutex for the receiver to lock and unlock the map for reads.
-		if (!memorybuffer.Open(namestring.c_str())) {
+	return false;
+}
+
+//---------------------------------------------------------
+// Function: CheckMemoryView
+// Check that the sender has not written to a view.
+//
+//    Call after the data has been used. If false, the data
+//    may be inconsistent and the view should be taken again.
+bool spoutDX::CheckMemoryView(const spoutMemoryView& view)
+{
+	if (!view.pHeader)
+		return false;
+	MemoryBarrier();
+	return (view.pHeader->sequence == view.sequence);
+}
+
+//---------------------------------------------------------
+// Function: CreateFrameMetadata
+// Create sender records for data describing each frame.
+//
+//    Each record is written for a sender frame number
+//    so that a receiver can find the data for the frame received.
+//    "length" is the maximum bytes of data for a frame and "slots" the
+//    number of frames retained for receivers that are behind the sender.
+//    If not called in advance, records are created by the first
+//    WriteFrameMetadata with the length of that data.
+//    The map is closed when the sender is released.
+bool spoutDX::CreateFrameMetadata(const char* name, int length, int slots)
+{
+	if (!name || !name[0] || length <= 0 || slots < 2) {
+		SpoutLogError("spoutDX::CreateFrameMetadata - invalid arguments");
+		return false;
+	}
+
+	if (metadata.Size() > 0) {
+		SpoutLogError("spoutDX::CreateFrameMetadata - frame metadata already exists");
+		return false;
+	}
+
+	// Records start on a cache line
+	const int slotsize = (length + 63) & ~63;
+	const int recordsize = (int)sizeof(SpoutMetadataRecord) + slotsize;
+
+	std::string namestring = name;
+	namestring += "_meta";
+	if (!metadata.Create(namestring.c_str(), (int)sizeof(SpoutMetadataHeader) + recordsize*slots)) {
+		SpoutLogError("spoutDX::CreateFrameMetadata - could not create shared memory");
+		return false;
+	}
+
+	// A map that remains open by a receiver has the size it was created with
+	if (metadata.Size() < (int)sizeof(SpoutMetadataHeader) + recordsize*slots) {
+		SpoutLogError("spoutDX::CreateFrameMetadata - existing shared memory is too small");
+		metadata.Close();
+		return false;
+	}
+
+	char* pBuffer = metadata.Lock();
+	if (!pBuffer) {
+		SpoutLogError("spoutDX::CreateFrameMetadata - no buffer lock");
+		metadata.Close();
+		return false;
+	}
+	SpoutMetadataHeader* header = (SpoutMetadataHeader*)pBuffer;
+	header->id = SPOUT_METADATA_ID;
+	header->slots = (uint32_t)slots;
+	header->slotsize = (uint32_t)slotsize;
+	header->frame = 0;
+	metadata.Unlock();
+
+	SpoutLogNotice("spoutDX::CreateFrameMetadata - %d records of %d bytes", slots, slotsize);
+
+	return true;
+}
+
+//---------------------------------------------------------
+// Function: WriteFrameMetadata
+// Write data for a sender frame.
+//
+//    The default frame is the next one to be sent,
+//    so call before SendTexture or SendImage.
+//    Receivers are not blocked. The record for the oldest
+//    frame is replaced and receivers reading it find the change.
+bool spoutDX::WriteFrameMetadata(const char* name, const char* data, int length, long framenumber)
+{
+	if (!data || length < 0) {
+		SpoutLogError("spoutDX::WriteFrameMetadata - no data");
+		return false;
+	}
+
+	if (metadata.Size() == 0) {
+		if (!CreateFrameMetadata(name, length))
+			return false;
+	}
+
+	if (framenumber <= 0)
+		framenumber = frame.GetSenderFrame() + 1;
+
+	SpoutMetadataHeader* header = (SpoutMetadataHeader*)metadata.Buffer();
+	int nbytes = length;
+	if (nbytes > (int)header->slotsize) {
+		SpoutLogWarning("spoutDX::WriteFrameMetadata - %d bytes reduced to %d", length, header->slotsize);
+		nbytes = (int)header->slotsize;
+	}
+
+	const int recordsize = (int)sizeof(SpoutMetadataRecord) + (int)header->slotsize;
+	char* pRecord = (char*)header + sizeof(SpoutMetadataHeader) + recordsize*(int)((unsigned long)framenumber % header->slots);
+	SpoutMetadataRecord* record = (SpoutMetadataRecord*)pRecord;
+
+	InterlockedIncrement(&record->sequence); // Odd while writing
+	record->frame = framenumber;
+	record->length = (uint32_t)nbytes;
+	memcpy(reinterpret_cast<void*>(pRecord + sizeof(SpoutMetadataRecord)), reinterpret_cast<const void*>(data), nbytes);
+	InterlockedIncrement(&record->sequence);
+
+	// Publish the frame for receivers
+	InterlockedExchange(&header->frame, framenumber);
+
+	return true;
+}
+
+//---------------------------------------------------------
+// Function: ReadFrameMetadata
+// Read data for a sender frame.
+//
+//    The default frame is the one last received.
+//    Returns the number of bytes written by the sender,
+//    or zero if there is no data for the frame.
+int spoutDX::ReadFrameMetadata(const char* name, char* data, int maxlength, long framenumber)
+{
+	if (!data || maxlength <= 0)
+		return 0;
+
+	if (!OpenFrameMetadata(name))
+		return 0;
+
+	if (framenumber <= 0)
+		framenumber = frame.GetSenderFrame();
+
+	const SpoutMetadataHeader* header = (const SpoutMetadataHeader*)metadata.Buffer();
+
+	// The frame is not written yet or has been replaced
+	const long latest = header->frame;
+	if (framenumber > latest || latest - framenumber >= (long)header->slots)
+		return 0;
+
+	const int recordsize = (int)sizeof(SpoutMetadataRecord) + (int)header->slotsize;
+	const char* pRecord = (const char*)header + sizeof(SpoutMetadataHeader) + recordsize*(int)((unsigned long)framenumber % header->slots);
+	const SpoutMetadataRecord* record = (const SpoutMetadataRecord*)pRecord;
+
+	for (int i = 0; i < SPOUT_SEQUENCE_RETRIES; i++) {
+		const LONG sequence = record->sequence;
+		if (sequence & 1) {
+			YieldProcessor();
+			continue;
+		}
+		MemoryBarrier();
+		if (record->frame != framenumber)
 			return 0;
+		int nbytes = (int)record->length;
+		if (nbytes > (int)header->slotsize)
+			nbytes = (int)header->slotsize;
+		if (nbytes > maxlength)
+			nbytes = maxlength;
+		memcpy(reinterpret_cast<void*>(data), reinterpret_cast<const void*>(pRecord + sizeof(SpoutMetadataRecord)), nbytes);
+		MemoryBarrier();
+		if (record->sequence == sequence) {
+			m_MetadataFrame = framenumber;
+			return nbytes;
 		}
-		SpoutLogNotice("spoutDX::GetMemoryBufferSize - opened sender memory map [%s]", memorybuffer.Name());
+	}
+
+	return 0;
+}
+
+//---------------------------------------------------------
+// Function: IsFrameMetadataNew
+// Has the sender written data for a frame after the last read.
+//
+//    Reads only the header of the records.
+bool spoutDX::IsFrameMetadataNew(const char* name)
+{
+	if (!OpenFrameMetadata(name))
+		return false;
+	const SpoutMetadataHeader* header = (const SpoutMetadataHeader*)metadata.Buffer();
+	return (header->frame != m_MetadataFrame);
+}
+
+//---------------------------------------------------------
+// Open sender frame metadata if not already
+bool spoutDX::OpenFrameMetadata(const char* name)
+{
+	if (metadata.Name())
+		return true;
+
+	if (!name || !name[0])
+		return false;
+
+	std::string namestring = name;
+	namestring += "_meta";
+	if (!metadata.Open(namestring.c_str()))
+		return false;
+
+	// Check the header and the size of all records
+	const SpoutMetadataHeader* header = (const SpoutMetadataHeader*)metadata.Buffer();
+	if (metadata.Size() < (int)sizeof(SpoutMetadataHeader)
+		|| header->id != SPOUT_METADATA_ID || header->slots == 0
+		|| (long long)sizeof(SpoutMetadataHeader) + ((long long)sizeof(SpoutMetadataRecord) + header->slotsize)*header->slots > metadata.Size()) {
+		SpoutLogError("spoutDX::OpenFrameMetadata - invalid frame metadata [%s]", namestring.c_str());
+		metadata.Close();
+		return false;
+	}
+
+	m_MetadataFrame = 0;
+
+	SpoutLogNotice("spoutDX::OpenFrameMetadata - opened [%s]", metadata.Name());
+
+	return true;
+}
+
+//---------------------------------------------------------
+// Close sender frame metadata
+void spoutDX::CloseFrameMetadata()
+{
+	metadata.Close();
+	m_MetadataFrame = 0;
+}
+
+//---------------------------------------------------------
+// Open a sender memory map if not already and read the size.
+// The size is saved as decimal digits in the first 16 bytes.
+bool spoutDX::OpenMemoryBuffer(const char* name)
+{
+	if (memorybuffer.Name())
+		return true;
+
+	if (!name || !name[0])
+		return false;
+
+	// Create a name for the map
+	std::string namestring = name;
+	namestring += "_map";
+	if (!memorybuffer.Open(namestring.c_str())) {
+		return false;
 	}
 
 	char* pBuffer = memorybuffer.Lock();
 	if (!pBuffer) {
-		SpoutLogError("spoutDX::GetMemoryBufferSize - no buffer lock");
-		return 0;
+		SpoutLogError("spoutDX::OpenMemoryBuffer - no buffer lock");
+		memorybuffer.Close();
+		return false;
 	}
+	char digits[16]={};
+	memcpy(digits, pBuffer, 15); // End for atoi
+	memorybuffer.Unlock();
 
-	// The number of bytes of the memory map available for data transfer
-	// is saved in the first 16 bytes.
-	*(pBuffer + 15) = 0; // End for atoi
-	int nbytes = atoi(reinterpret_cast<char *>(pBuffer));
+	m_MemoryCapacity = atoi(digits);
+	if (m_MemoryCapacity < 0 || 16 + m_MemoryCapacity > memorybuffer.Size()) {
+		SpoutLogError("spoutDX::OpenMemoryBuffer - invalid size %d", m_MemoryCapacity);
+		memorybuffer.Close();
+		m_MemoryCapacity = 0;
+		return false;
+	}
 
-	memorybuffer.Unlock();
+	SpoutLogNotice("spoutDX::OpenMemoryBuffer - opened sender memory map [%s]", memorybuffer.Name());
 
-	return nbytes;
+	return true;
+}
+
+//---------------------------------------------------------
+// Close sender memory maps
+void spoutDX::CloseMemoryBuffer()
+{
+	memorybuffer.Close();
+	if (m_pMemoryMap) {
+		delete m_pMemoryMap;
+		m_pMemoryMap = nullptr;
+	}
+	m_MemoryCapacity = 0;
+	m_MemoryMapCapacity = 0;
+	m_MemoryMapNumber = 0;
+}
+
+//---------------------------------------------------------
+// Create a larger buffer "<sender>_map_<n>" and let
+// receivers of the current buffers know to change to it.
+bool spoutDX::GrowMemoryBuffer(const char* name, int length)
+{
+	int capacity = m_pMemoryMap ? m_MemoryMapCapacity : m_MemoryCapacity;
+	capacity *= 2;
+	if (capacity < length)
+		capacity = length;
+
+	// A map of the same name could remain open by a receiver
+	SpoutSharedMemory* pMap = new SpoutSharedMemory();
+	LONG number = m_MemoryMapNumber;
+	SpoutCreateResult result = SPOUT_CREATE_FAILED;
+	for (int i = 0; i < 16; i++) {
+		number++;
+		std::string namestring = name;
+		namestring += "_map_";
+		namestring += std::to_string(number);
+		result = pMap->Create(namestring.c_str(), (int)sizeof(SpoutMemoryHeader) + capacity + 16);
+		if (result == SPOUT_CREATE_SUCCESS)
+			break;
+		pMap->Close();
+	}
+	if (result != SPOUT_CREATE_SUCCESS) {
+		delete pMap;
+		return false;
+	}
+
+	char* pBuffer = pMap->Lock();
+	if (!pBuffer) {
+		delete pMap;
+		return false;
+	}
+	SpoutMemoryHeader* header = (SpoutMemoryHeader*)pBuffer;
+	header->id = SPOUT_MEMORY_ID;
+	header->version = SPOUT_MEMORY_VERSION;
+	header->capacity = (uint32_t)capacity;
+	pMap->Unlock();
+
+	// Receivers of the original and any previous buffer change to the new one
+	pBuffer = memorybuffer.Lock();
+	if (pBuffer) {
+		SpoutMemoryHeader* original = (SpoutMemoryHeader*)(pBuffer + MemoryHeaderOffset(m_MemoryCapacity));
+		InterlockedExchange(&original->next, number);
+		memorybuffer.Unlock();
+	}
+	if (m_pMemoryMap) {
+		pBuffer = m_pMemoryMap->Lock();
+		if (pBuffer) {
+			InterlockedExchange(&((SpoutMemoryHeader*)pBuffer)->next, number);
+			m_pMemoryMap->Unlock();
+		}
+		delete m_pMemoryMap;
+	}
+
+	m_pMemoryMap = pMap;
+	m_MemoryMapCapacity = capacity;
+	m_MemoryMapNumber = number;
+
+	SpoutLogNotice("spoutDX::GrowMemoryBuffer - created memory buffer %d bytes", capacity);
+
+	return true;
+}
+
+//---------------------------------------------------------
+// Return the header and data of the current sender buffer,
+// opening any larger buffer that has replaced it.
+// Returns nullptr for earlier senders without the header.
+const SpoutMemoryHeader* spoutDX::FollowMemoryBuffer(const char* name, const char** ppData)
+{
+	const SpoutMemoryHeader* header = nullptr;
+	const char* pData = nullptr;
+
+	if (m_pMemoryMap) {
+		header = (const SpoutMemoryHeader*)m_pMemoryMap->Buffer();
+		pData = m_pMemoryMap->Buffer() + sizeof(SpoutMemoryHeader);
+	}
+	else {
+		const int offset = MemoryHeaderOffset(m_MemoryCapacity);
+		if (offset + (int)sizeof(SpoutMemoryHeader) > memorybuffer.Size())
+			return nullptr;
+		header = (const SpoutMemoryHeader*)(memorybuffer.Buffer() + offset);
+		if (header->id != SPOUT_MEMORY_ID || header->capacity != (uint32_t)m_MemoryCapacity)
+			return nullptr;
+		pData = memorybuffer.Buffer() + 16;
+	}
+
+	// The sender has created a larger buffer
+	while (header->next != 0) {
+		const LONG number = header->next;
+		std::string namestring = name;
+		namestring += "_map_";
+		namestring += std::to_string(number);
+		SpoutSharedMemory* pMap = new SpoutSharedMemory();
+		if (!pMap->Open(namestring.c_str())) {
+			// Continue with the current buffer
+			delete pMap;
+			break;
+		}
+		const SpoutMemoryHeader* next = (const SpoutMemoryHeader*)pMap->Buffer();
+		if (next->id != SPOUT_MEMORY_ID
+			|| (int)(sizeof(SpoutMemoryHeader) + next->capacity) > pMap->Size()) {
+			delete pMap;
+			break;
+		}
+		if (m_pMemoryMap)
+			delete m_pMemoryMap;
+		m_pMemoryMap = pMap;
+		m_MemoryMapCapacity = (int)next->capacity;
+		m_MemoryMapNumber = number;
+		header = next;
+		pData = pMap->Buffer() + sizeof(SpoutMemoryHeader);
+		SpoutLogNotice("spoutDX::FollowMemoryBuffer - changed to memory map [%s] %d bytes", pMap->Name(), m_MemoryMapCapacity);
+	}
+
+	*ppData = pData;
 
+	return header;
 }
 
 //
@@ -2005,6 +2741,23 @@ bool spoutDX::GetSwap()
 	return m_bSwapRB;
 }
 
+//---------------------------------------------------------
+// Function: SetSRGB
+// Set sRGB encoding of linear floating point sender textures.
+// Default is true.
+void spoutDX::SetSRGB(bool bSRGB)
+{
+	m_bSRGB = bSRGB;
+}
+
+//---------------------------------------------------------
+// Function: GetSRGB
+// Return sRGB option
+bool spoutDX::GetSRGB()
+{
+	return m_bSRGB;
+}
+
 
 //
 // Sharing modes
@@ -2280,6 +3033,10 @@ bool spoutDX::CheckSender(unsigned int width, unsigned int height, DWORD dwForma
 //---------------------------------------------------------
 // Used when the sender was there but the texture pointer could not be retrieved from the share handle.
 // Try using the sender adapter if different.
+//
+// A device is retained for each adapter used, together with its staging textures.
+// If the share handle can be opened by a device already created, the receiver
+// binds to it. Otherwise a device is created for the sender adapter and added.
 ID3D11Texture2D* spoutDX::CheckSenderTexture(char *sendername, HANDLE dxShareHandle)
 {
 	// If auto adapter switching not activated, return a NULL pointer
@@ -2290,43 +3047,233 @@ ID3D11Texture2D* spoutDX::CheckSenderTexture(char *sendername, HANDLE dxShareHan
 
 	ID3D11Texture2D* pTexture =  nullptr;
 
-	// Save the current adapter index
-	int receiverindex = GetAdapter();
+	// Devices already created for other adapters
+	for (size_t i = 0; i < m_pDevicePool->size(); i++) {
+		const spoutAdapterDevice& dev = (*m_pDevicePool)[i];
+		if (dev.pDevice == m_pd3dDevice)
+			continue;
+		if (spoutdx.OpenDX11shareHandle(dev.pDevice, &pTexture, dxShareHandle)) {
+			BindAdapterDevice(i);
+			SpoutLogNotice("spoutDX::CheckSenderTexture - changed to retained device (0x%.7X)", PtrToUint(m_pd3dDevice));
+			return pTexture;
+		}
+	}
 
 	// Get the sender adapter index
-	int senderindex = GetSenderAdapter(sendername);
-		
-	// If they are different, switch to the sender adapter
-	if (receiverindex != senderindex) {
+	const int senderindex = GetSenderAdapter(sendername);
+	if (senderindex < 0) {
+		SpoutLogWarning("spoutDX::CheckSenderTexture - could not find sender adapter");
+		return nullptr;
+	}
 
-		CloseDirectX11(); // Close the current DX11 device
+	IDXGIAdapter* pAdapter = GetAdapterPointer(senderindex);
+	if (!pAdapter)
+		return nullptr;
 
-		SetAdapter(senderindex); // Change to the same adapter as the sender
-		
-		OpenDirectX11(); // Create a new device with that adapter
+	DXGI_ADAPTER_DESC desc={};
+	pAdapter->GetDesc(&desc);
 
-		// Try again to get the texture pointer
-		if (!spoutdx.OpenDX11shareHandle(m_pd3dDevice, &pTexture, dxShareHandle)) {
+	// If the adapter is the same, the share handle still could not be opened
+	LUID luid={};
+	if (GetDeviceLuid(m_pd3dDevice, &luid)
+		&& luid.LowPart == desc.AdapterLuid.LowPart
+		&& luid.HighPart == desc.AdapterLuid.HighPart) {
+		pAdapter->Release();
+		return nullptr;
+	}
 
-			// If that didn't work, change back to the original adapter
-			CloseDirectX11();
-			SetAdapter(receiverindex);
-			OpenDirectX11();
-			SpoutLogWarning("spoutDX::CheckSenderTexture - could not change to sender adapter %d", senderindex);
+	// Create a device for the sender adapter
+	spoutAdapterDevice dev={};
+	dev.luid = desc.AdapterLuid;
+	dev.bOwned = true;
+	dev.pDevice = CreateAdapterDevice(pAdapter, &dev.pContext);
+	pAdapter->Release();
+	if (!dev.pDevice) {
+		SpoutLogWarning("spoutDX::CheckSenderTexture - could not create device for sender adapter %d", senderindex);
+		return nullptr;
+	}
 
-			return nullptr;
+	if (!spoutdx.OpenDX11shareHandle(dev.pDevice, &pTexture, dxShareHandle)) {
+		dev.pContext->Flush();
+		dev.pContext->Release();
+		dev.pDevice->Release();
+		SpoutLogWarning("spoutDX::CheckSenderTexture - could not change to sender adapter %d", senderindex);
+		return nullptr;
+	}
+
+	// Retain the device and use it for receiving
+	m_pDevicePool->push_back(dev);
+	BindAdapterDevice(m_pDevicePool->size()-1);
+	SpoutLogNotice("spoutDX::CheckSenderTexture - changed to sender adapter %d", senderindex);
+
+	return pTexture;
+
+}
+
+//---------------------------------------------------------
+// Use a retained device for receiving.
+// The current device and staging textures are saved to the pool.
+void spoutDX::BindAdapterDevice(size_t index)
+{
+	if (index >= m_pDevicePool->size())
+		return;
+
+	// Save the current device
+	bool bFound = false;
+	for (auto& dev : *m_pDevicePool) {
+		if (dev.pDevice == m_pd3dDevice) {
+			dev.pContext = m_pImmediateContext;
+			bFound = true;
+			break;
 		}
+	}
+	if (!bFound) {
+		// The class device is retained but not released by the pool
+		spoutAdapterDevice current={};
+		GetDeviceLuid(m_pd3dDevice, &current.luid);
+		current.pDevice = m_pd3dDevice;
+		current.pContext = m_pImmediateContext;
+		current.bOwned = false;
+		m_pDevicePool->push_back(current);
+	}
+	SaveStagingTextures();
 
-		// The sharehandle opened OK with the new adapter
-		SpoutLogNotice("spoutDX::CheckSenderTexture - changed to sender adapter %d", senderindex);
+	// The class texture was created by the current device
+	if (m_pTexture) spoutdx.ReleaseDX11Texture(m_pd3dDevice, m_pTexture);
+	m_pTexture = nullptr;
+	if (m_pImmediateContext) m_pImmediateContext->Flush();
 
-		return pTexture;
+	const spoutAdapterDevice& dev = (*m_pDevicePool)[index];
+	m_pd3dDevice = dev.pDevice;
+	m_pImmediateContext = dev.pContext;
+	RestoreStagingTextures();
+	m_Index = 0;
+	m_NextIndex = 0;
+	m_StagingFrame[0] = m_StagingFrame[1] = 0;
+	m_StagingTime[0] = m_StagingTime[1] = 0;
+
+}
 
+//---------------------------------------------------------
+// Move the class staging textures to the pool entry of the current device.
+// The pool holds staging textures only while they are not in use.
+// Returns false if the device is not in the pool.
+bool spoutDX::SaveStagingTextures()
+{
+	for (auto& dev : *m_pDevicePool) {
+		if (dev.pDevice == m_pd3dDevice) {
+			if (m_pStaging[0] || m_pStaging[1]) {
+				for (int i = 0; i < 2; i++) {
+					if (dev.pStaging[i] && dev.pStaging[i] != m_pStaging[i])
+						spoutdx.ReleaseDX11Texture(dev.pDevice, dev.pStaging[i]);
+					dev.pStaging[i] = m_pStaging[i];
+				}
+			}
+			m_pStaging[0] = nullptr;
+			m_pStaging[1] = nullptr;
+			return true;
+		}
 	}
+	return false;
+}
 
-	// The adapter was not different so the sharehandle still could not be opened
-	return nullptr;
+//---------------------------------------------------------
+// Take back staging textures saved for the current device.
+// Existing class staging textures are not replaced.
+void spoutDX::RestoreStagingTextures()
+{
+	if (m_pStaging[0] || m_pStaging[1])
+		return;
+	for (auto& dev : *m_pDevicePool) {
+		if (dev.pDevice == m_pd3dDevice) {
+			m_pStaging[0] = dev.pStaging[0];
+			m_pStaging[1] = dev.pStaging[1];
+			dev.pStaging[0] = nullptr;
+			dev.pStaging[1] = nullptr;
+			return;
+		}
+	}
+}
 
+//---------------------------------------------------------
+// Release devices created for other adapters.
+// Staging textures saved in the pool are released.
+// Class staging textures are released by the caller.
+void spoutDX::ReleaseDevicePool()
+{
+	ID3D11Device* pCurrent = m_pd3dDevice;
+	for (auto& dev : *m_pDevicePool) {
+		const bool bCurrent = (dev.pDevice == pCurrent);
+		if (dev.pStaging[0]) spoutdx.ReleaseDX11Texture(dev.pDevice, dev.pStaging[0]);
+		if (dev.pStaging[1]) spoutdx.ReleaseDX11Texture(dev.pDevice, dev.pStaging[1]);
+		dev.pStaging[0] = nullptr;
+		dev.pStaging[1] = nullptr;
+		if (dev.bOwned) {
+			if (dev.pContext) {
+				dev.pContext->ClearState();
+				dev.pContext->Flush();
+				dev.pContext->Release();
+			}
+			dev.pDevice->Release();
+		}
+		else if (!bCurrent) {
+			// Restore the class device for release
+			m_pd3dDevice = dev.pDevice;
+			m_pImmediateContext = dev.pContext;
+		}
+	}
+	m_pDevicePool->clear();
+}
+
+//---------------------------------------------------------
+// Create a device and immediate context for a given adapter
+// without changing the class device
+ID3D11Device* spoutDX::CreateAdapterDevice(IDXGIAdapter* pAdapter, ID3D11DeviceContext** ppContext)
+{
+	if (!pAdapter || !ppContext)
+		return nullptr;
+
+	const D3D_FEATURE_LEVEL featureLevels[] = {
+		D3D_FEATURE_LEVEL_11_1,
+		D3D_FEATURE_LEVEL_11_0,
+		D3D_FEATURE_LEVEL_10_1,
+		D3D_FEATURE_LEVEL_10_0,
+	};
+
+	ID3D11Device* pDevice = nullptr;
+	const HRESULT hr = D3D11CreateDevice(pAdapter, D3D_DRIVER_TYPE_UNKNOWN, NULL, 0,
+		featureLevels, ARRAYSIZE(featureLevels), D3D11_SDK_VERSION,
+		&pDevice, NULL, ppContext);
+	if (FAILED(hr))
+		return nullptr;
+
+	return pDevice;
+}
+
+//---------------------------------------------------------
+// Get the adapter LUID of a device
+bool spoutDX::GetDeviceLuid(ID3D11Device* pDevice, LUID* pLuid)
+{
+	if (!pDevice || !pLuid)
+		return false;
+
+	IDXGIDevice* pDXGIDevice = nullptr;
+	if (FAILED(pDevice->QueryInterface(__uuidof(IDXGIDevice), (void**)&pDXGIDevice)))
+		return false;
+
+	bool bRet = false;
+	IDXGIAdapter* pAdapter = nullptr;
+	if (SUCCEEDED(pDXGIDevice->GetAdapter(&pAdapter))) {
+		DXGI_ADAPTER_DESC desc={};
+		if (SUCCEEDED(pAdapter->GetDesc(&desc))) {
+			*pLuid = desc.AdapterLuid;
+			bRet = true;
+		}
+		pAdapter->Release();
+	}
+	pDXGIDevice->Release();
+
+	return bRet;
 }
 
 //---------------------------------------------------------
@@ -2370,8 +3317,9 @@ bool spoutDX::ReceiveSenderData()
 
 	// Try to get the sender shared memory information.
 	// Retrieve width, height, sharehandle and format.
+	// The connected sender map is kept open and read again only if changed.
 	SharedTextureInfo info={};
-	if (sendernames.getSharedInfo(sendername, &info)) {
+	if (sendernames.CheckSenderInfo(sendername, &info)) {
 
 		// Memory share mode not supported (no texture share handle)
 		if (info.shareHandle == 0) {
@@ -2530,7 +3478,23 @@ bool spoutDX::ReadPixelData(ID3D11Texture2D* pStagingSource, unsigned char* dest
 	const HRESULT hr = m_pImmediateContext->Map(pStagingSource, 0, D3D11_MAP_READ, 0, &mappedSubResource);
 	if (SUCCEEDED(hr)) {
 		// Copy the staging texture pixels to the user buffer
-		if (!bRGB) {
+		if (m_dwFormat == 24 || m_dwFormat == 11 || m_dwFormat == 10) {
+			//
+			// 10 bit, 16 bit or floating point texture to RGBA/BGRA/RGB/BGR pixels
+			// Texture channel order is RGBA
+			// RGBA pixels default, BGRA for swap
+			// BGR pixels default, RGB for swap
+			//
+			GLenum glFormat = GL_RGBA;
+			if (bRGB)
+				glFormat = bSwap ? GL_RGB : GL_BGR_EXT;
+			else if (bSwap)
+				glFormat = GL_BGRA_EXT;
+			spoutcopy.hdr2rgba(mappedSubResource.pData, destpixels, m_Width, m_Height,
+				mappedSubResource.RowPitch, width, height, m_dwFormat, glFormat,
+				bInvert, bRGB && m_bMirror, m_bSRGB);
+		}
+		else if (!bRGB) {
 			//
 			// RGBA pixel buffer
 			//
@@ -2601,6 +3565,9 @@ bool spoutDX::CheckStagingTextures(unsigned int width, unsigned int height, DWOR
 		return false;
 	}
 
+	// Staging textures retained with the device by ReleaseReceiver
+	RestoreStagingTextures();
+
 	if (m_pStaging[0] && m_pStaging[1]) {
 
 		// Get the texture details to test for change (both textures are the same)
@@ -2614,6 +3581,8 @@ bool spoutDX::CheckStagingTextures(unsigned int width, unsigned int height, DWOR
 		// Drop through to create new staging textures
 		m_Index = 0;
 		m_NextIndex = 0;
+		m_StagingFrame[0] = m_StagingFrame[1] = 0;
+		m_StagingTime[0] = m_StagingTime[1] = 0;
 
 	}
 
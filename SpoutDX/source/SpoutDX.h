@@ -67,6 +67,31 @@
 #include <psapi.h> // for GetModuleFileNameExA
 #pragma comment(lib, "Psapi.lib")
 
+//
+// Receiving device for a graphics adapter.
+// Devices are retained for each adapter used by a sender
+// so that the receiver can change without re-creating them.
+//
+struct spoutAdapterDevice {
+	LUID luid;                     // Adapter locally unique identifier
+	ID3D11Device* pDevice;         // Device created for the adapter
+	ID3D11DeviceContext* pContext; // Immediate context of the device
+	ID3D11Texture2D* pStaging[2];  // Staging textures while not in use
+	bool bOwned;                   // Device created by the pool
+};
+
+//
+// View of sender shared memory data without copying.
+// Valid until the next memory buffer read or the receiver is released.
+// Check the view with CheckMemoryView after the data has been used.
+//
+struct spoutMemoryView {
+	const char* data;                  // Sender data in the memory map
+	int length;                        // Number of bytes written by the sender
+	LONG sequence;                     // Write sequence when the view was made
+	const SpoutMemoryHeader* pHeader;  // Header of the memory map
+};
+
 class SPOUT_DLLEXP spoutDX {
 
 	public:
@@ -148,6 +173,8 @@ class SPOUT_DLLEXP spoutDX {
 	bool IsConnected();
 	// Received frame is new
 	bool IsFrameNew();
+	// Received image buffer was not written
+	bool IsFrameUnchanged();
 	// Received texture
 	ID3D11Texture2D* GetSenderTexture();
 	// Received sender share handle
@@ -162,8 +189,26 @@ class SPOUT_DLLEXP spoutDX {
 	unsigned int GetSenderHeight();
 	// Received sender frame rate
 	double GetSenderFps();
+	// Received sender frame rate statistics
+	bool GetSenderFrameStats(SpoutFrameStats& stats);
+	// Number of frame intervals for sender frame rate statistics
+	void SetSenderFpsWindow(int frames = SPOUT_FPS_WINDOW);
+	// Time to wait for the sender texture (msec, 0 - do not wait)
+	void SetAccessTimeout(DWORD dwTimeout = SPOUT_ACCESS_TIMEOUT);
+	// Sender texture access waits
+	bool GetAccessStats(SpoutAccessStats& stats);
+	// Receiver - the sender waits for this receiver to take each frame
+	void SetLockStep(bool bLockStep = true);
+	// Sender - time to wait for lock-step receivers (msec, 0 - do not wait)
+	void SetReceiverWait(DWORD dwTimeout);
+	// Frames behind the sender for each receiver
+	int GetReceiverLag(long* lag, int maxreceivers);
 	// Received sender frame number
 	long GetSenderFrame();
+	// Sender frame number of the pixels received by ReceiveImage
+	long GetImageFrame();
+	// Sender clock time of the pixels received by ReceiveImage
+	LONG64 GetImageTime();
 	
 	//
 	// COMMON
@@ -179,6 +224,10 @@ class SPOUT_DLLEXP spoutDX {
 	void SetFrameSync(const char* SenderName);
 	// Wait or test for a sync event
 	bool WaitFrameSync(const char *SenderName, DWORD dwTimeout = 0);
+	// Wait for a new frame from the connected sender
+	bool WaitNewFrame(DWORD dwTimeout);
+	// The connected sender frame number can be waited for
+	bool CanWaitNewFrame();
 
 								
 	//
@@ -193,6 +242,8 @@ class SPOUT_DLLEXP spoutDX {
 	std::vector<std::string> GetSenderList();
 	// Sender index into the set of names
 	int GetSenderIndex(const char* sendername);
+	// Count of sender changes
+	long GetSenderChanges();
 	// Get sender details
 	bool GetSenderInfo(const char* sendername, unsigned int &width, unsigned int &height, HANDLE &dxShareHandle, DWORD &dwFormat);
 	// Get active sender name
@@ -307,6 +358,23 @@ class SPOUT_DLLEXP spoutDX {
 	bool DeleteMemoryBuffer();
 	// Get the number of bytes available for data transfer
 	int  GetMemoryBufferSize(const char *name);
+	// View data in shared memory without copying
+	bool GetMemoryView(const char* name, spoutMemoryView& view);
+	// Check that the sender has not written to a view
+	bool CheckMemoryView(const spoutMemoryView& view);
+
+	//
+	// Frame metadata
+	//
+
+	// Create records for data describing each frame
+	bool CreateFrameMetadata(const char* name, int length, int slots = SPOUT_METADATA_SLOTS);
+	// Write data for a sender frame
+	bool WriteFrameMetadata(const char* name, const char* data, int length, long framenumber = 0);
+	// Read data for a sender frame
+	int  ReadFrameMetadata(const char* name, char* data, int maxlength, long framenumber = 0);
+	// Has the sender written data for a new frame
+	bool IsFrameMetadataNew(const char* name);
 
 	//
 	// Options used for SpoutCam
@@ -322,6 +390,11 @@ class SPOUT_DLLEXP spoutDX {
 
 	bool GetSwap();
 
+	// Encode floating point sender textures as sRGB
+	void SetSRGB(bool bSRGB = true);
+
+	bool GetSRGB();
+
 	//
 	// Public for external access
 	//
@@ -340,6 +413,8 @@ protected :
 	ID3D11Texture2D* m_pStaging[2];
 	int m_Index;
 	int m_NextIndex;
+	long m_StagingFrame[2]; // Sender frame copied to each staging texture
+	LONG64 m_StagingTime[2]; // Sender time of the frame
 
 	HANDLE m_dxShareHandle;
 	DWORD m_dwFormat;
@@ -349,6 +424,7 @@ protected :
 	unsigned int m_Width;
 	unsigned int m_Height;
 	bool m_bUpdated;
+	bool m_bFrameUnchanged; // ReceiveImage did not write the pixel buffer
 	bool m_bConnected;
 	bool m_bSpoutInitialized;
 	bool m_bSpoutPanelOpened;
@@ -358,14 +434,39 @@ protected :
 	bool m_bMemoryShare; // Using 2.006 memoryshare methods
 	bool m_bMirror; // Mirror image
 	bool m_bSwapRB; // RGB <> BGR
+	bool m_bSRGB; // Linear to sRGB for floating point textures
 	SHELLEXECUTEINFOA m_ShExecInfo; // For ShellExecute
 
 	// For WriteMemoryBuffer/ReadMemoryBuffer
 	SpoutSharedMemory memorybuffer;
+	SpoutSharedMemory* m_pMemoryMap; // Larger buffer that replaces memorybuffer
+	int m_MemoryCapacity; // Bytes available for data in memorybuffer
+	int m_MemoryMapCapacity; // Bytes available for data in m_pMemoryMap
+	LONG m_MemoryMapNumber; // Number of m_pMemoryMap
+	bool OpenMemoryBuffer(const char* name);
+	void CloseMemoryBuffer();
+	bool GrowMemoryBuffer(const char* name, int length);
+	const SpoutMemoryHeader* FollowMemoryBuffer(const char* name, const char** ppData);
+
+	// For WriteFrameMetadata/ReadFrameMetadata
+	SpoutSharedMemory metadata;
+	long m_MetadataFrame; // Frame of the last record read
+	bool OpenFrameMetadata(const char* name);
+	void CloseFrameMetadata();
 
 	bool CheckSender(unsigned int width, unsigned int height, DWORD dwFormat);
 	ID3D11Texture2D* CheckSenderTexture(char *sendername, HANDLE dxShareHandle);
 
+	// Receiving devices for each graphics adapter used by a sender
+	// Pointer to avoid size differences between compilers
+	std::vector<spoutAdapterDevice>* m_pDevicePool;
+	void BindAdapterDevice(size_t index);
+	void ReleaseDevicePool();
+	bool SaveStagingTextures();
+	void RestoreStagingTextures();
+	ID3D11Device* CreateAdapterDevice(IDXGIAdapter* pAdapter, ID3D11DeviceContext** ppContext);
+	bool GetDeviceLuid(ID3D11Device* pDevice, LUID* pLuid);
+
 	bool ReceiveSenderData();
 	void CreateReceiver(const char * sendername, unsigned int width, unsigned int height, DWORD dwFormat);
 	
@@ -89,6 +89,31 @@
 //		31.12.23	- Add comments to clarify the purpose of "EnableFrameSync"
 //	Version 2.007.014
 //		04.07.24	- SetNewFrame - add m_hCountSemaphore to initial check
+//		18.10.26	- Add WaitNewFrame for event driven receivers
+//					  WaitNewFrame tests the frame number and does not take the sender
+//					  sync event. Add CanWaitNewFrame.
+//					- Add a frame control block with the frame number, time and period
+//					  written by the sender with the semaphore count. GetNewFrame reads it
+//					  without kernel calls and uses the semaphore for earlier senders.
+//					  Add GetFrameControl and ProfileFrameCount.
+//					- Sender fps from control block times over a window of frame intervals.
+//					  The window restarts if the frame rate changes. Add GetFrameStats
+//					  for mean fps, median interval, jitter, dropped and missed frames.
+//					- HoldFps uses spoutFramePacer for absolute frame deadlines
+//					  with the Windows timer period held for the object lifetime.
+//					  Add SetHoldSpin for a spin wait before the deadline.
+//					- Add texture access wait statistics and SetAccessTimeout.
+//					  A zero timeout tries once so that the caller can re-use
+//					  the last frame if the sender holds the texture.
+//					- Add receiver slots to the frame control block. Receivers acknowledge
+//					  each frame and a sender can wait for lock-step receivers.
+//					  Add SetLockStep, SetReceiverWait, WaitReceivers, GetReceiverLag.
+//					  Slots of receivers that have closed or stopped acknowledging
+//					  frames are reclaimed. The slot time identifies the owner.
+//					- Use the SpoutUtils monotonic clock for all timing. Sender fps
+//					  no longer depends on USE_CHRONO. With the test clock enabled,
+//					  pacing and fps can be checked without waiting.
+//					- Add GetSenderFrameTime for the sender time of the received frame
 //
 // ====================================================================================
 //
@@ -118,6 +143,8 @@
 
 #include "SpoutFrameCount.h"
 
+static bool IsReceiverProcessExited(DWORD dwProcId);
+
 //
 // Class: spoutFrameCount
 //
@@ -130,20 +157,34 @@
 spoutFrameCount::spoutFrameCount()
 {
 	m_hAccessMutex = NULL;
+	m_AccessTimeout = SPOUT_ACCESS_TIMEOUT;
+	m_AccessStats = {};
 	m_hCountSemaphore = NULL;
 	m_hSyncEvent = NULL;
 	m_SenderName[0] = 0;
 	m_CountSemaphoreName[0] = 0;
 	
 	m_FrameCount = 0L;
+	m_FrameTimestamp = 0;
 	m_LastFrameCount = 0L;
 	m_FrameTime = 0.0;
 	m_FrameTimeTotal = 0.0;
 	m_FrameTimeNumber = 0.0;
 	m_lastFrame = 0.0;
+	m_bFrameControl = false;
+	m_bFramePublisher = false;
+	m_ReceiverSlot = -1;
+	m_SlotTimestamp = 0;
+	m_SlotScanTime = 0;
+	m_bLockStep = false;
+	m_ReceiverWait = 0;
+	m_pFrameIntervals = new std::vector<double>;
+	m_pFrameSpans = new std::vector<long>;
+	m_FpsWindow = SPOUT_FPS_WINDOW;
+	m_RateChange = 0;
+	m_LastTimestamp = 0;
 	m_SystemFps = GetRefreshRate(); // System refresh rate
 	m_SenderFps = m_SystemFps; // Default sender fps is system refresh rate
-	m_PeriodMin = 0; // For setting Windows time period
 	m_bIsNewFrame = true; // Default true for apps without frame count
 
 	// Check the registry setting for frame counting between sender and receiver
@@ -166,24 +207,8 @@ spoutFrameCount::spoutFrameCount()
 	// Default is enabled.
 	m_bFrameSync = true;
 
-#ifdef USE_CHRONO
-
-	// For HoldFps
-	m_FrameStartPtr = new std::chrono::steady_clock::time_point;
-	m_FrameEndPtr = new std::chrono::steady_clock::time_point;
-
-	// Sender fps
-	m_FpsStartPtr = new std::chrono::steady_clock::time_point;
-	m_FpsEndPtr = new std::chrono::steady_clock::time_point;
-
-	// Reset both counts
-	*m_FrameStartPtr = *m_FrameEndPtr = std::chrono::steady_clock::now();
-	*m_FpsStartPtr = *m_FpsEndPtr = std::chrono::steady_clock::now();
-
-#else
-	// Initialize PC msec frequency counter
-	StartCounter();
-#endif
+	// Sender fps start time
+	m_lastFrame = ClockTicksToMilliseconds(GetClockTicks());
 
 }
 
@@ -191,17 +216,13 @@ spoutFrameCount::spoutFrameCount()
 spoutFrameCount::~spoutFrameCount()
 {
 
-#ifdef USE_CHRONO
-	if(m_FrameStartPtr)	delete m_FrameStartPtr;
-	if(m_FrameEndPtr) delete m_FrameEndPtr;
-	if(m_FpsStartPtr) delete m_FpsStartPtr;
-	if(m_FpsEndPtr) delete m_FpsEndPtr;
-#endif
-
 	if (m_hCountSemaphore) CloseHandle(m_hCountSemaphore);
 	if (m_hAccessMutex) CloseHandle(m_hAccessMutex);
 	if (m_hSyncEvent) CloseHandle(m_hSyncEvent);
 
+	delete m_pFrameIntervals;
+	delete m_pFrameSpans;
+
 }
 
 
@@ -271,21 +292,25 @@ void spoutFrameCount::EnableFrameCount(const char* SenderName)
 
 	// Reset frame count, comparator and fps variables
 	m_FrameCount = 0L;
+	m_FrameTimestamp = 0;
 	m_LastFrameCount = 0L;
 	m_FrameTime = 0.0;
 	m_FrameTimeTotal = 0.0;
 	m_FrameTimeNumber = 0.0;
 	m_SenderFps = m_SystemFps; // Default sender fps is system refresh rate
-
-	// Reset timers
-#ifdef USE_CHRONO
-	// Reset the counts
-	* m_FrameStartPtr = *m_FrameEndPtr = std::chrono::steady_clock::now();
-	*m_FpsStartPtr = *m_FpsEndPtr = std::chrono::steady_clock::now();
-#else
-	// Initialize PC msec frequency counter
-	StartCounter();
-#endif
+	ResetFrameIntervals();
+
+	// Reset the sender fps start time
+	m_lastFrame = ClockTicksToMilliseconds(GetClockTicks());
+
+	// Create or open the frame control block.
+	// Either the sender or receiver can create it.
+	if (!m_FrameControl.Buffer()) {
+		char controlname[256]={};
+		sprintf_s(controlname, 256, "%s_Count_Control", SenderName);
+		if (m_FrameControl.Create(controlname, (int)sizeof(SpoutFrameControl)) == SPOUT_CREATE_FAILED)
+			SpoutLogWarning("    could not create frame control [%s]", controlname);
+	}
 
 	// Return if already enabled for this sender
 	// The sender name can be the same if the adapter has changed
@@ -404,6 +429,17 @@ long spoutFrameCount::GetSenderFrame()
 	return m_FrameCount;
 }
 
+// -----------------------------------------------
+// Function: GetSenderFrameTime
+// Sender clock time of the received frame.
+//
+// The time the sender published the frame returned by GetSenderFrame.
+// Zero if the sender does not publish the frame control block.
+LONG64 spoutFrameCount::GetSenderFrameTime()
+{
+	return m_FrameTimestamp;
+}
+
 
 // -----------------------------------------------
 // Function: HoldFps
@@ -413,17 +449,13 @@ long spoutFrameCount::GetSenderFrame()
 // have frame rate control. Must be called every frame.
 // The sender will then signal a new frame at the target rate.
 //
+// Frames are held to absolute deadlines by spoutFramePacer so that
+// the rate does not drift due to Sleep precision. The Windows timer
+// period is reduced for the lifetime of the object rather than each frame.
+//
 // Note that this function is affected by changes to Windows timer 
 // resolution since Windows 10 Version 2004 (April 2020)
 // https://randomascii.wordpress.com/2020/10/04/windows-timer-resolution-the-great-rule-change/
-//
-// TimeBeginPeriod / TimeEndPeriod avoid loss of precision
-// https://learn.microsoft.com/en-us/windows/win32/api/timeapi/nf-timeapi-timebeginperiod
-// Microsoft remark :
-//   Call this function immediately before using timer services, and call the timeEndPeriod
-//   function immediately after you are finished using the timer services. An application 
-//   can make multiple timeBeginPeriod calls as long as each call is matched with a call
-//   to timeEndPeriod.
 // 
 void spoutFrameCount::HoldFps(int fps)
 {
@@ -431,45 +463,19 @@ void spoutFrameCount::HoldFps(int fps)
 	if (fps <= 0)
 		return;
 
-	// Reduce Windows timer period to minimum
-	StartTimePeriod();
-
-	// Target frame time
-	const double target = (1000000.0/static_cast<double>(fps))/1000.0; // msec
-
-#ifdef USE_CHRONO
-
-	// Time now end point
-	*m_FrameEndPtr = std::chrono::steady_clock::now();
-
-	// Milliseconds elapsed
-	const double elapsedTime = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(*m_FrameEndPtr - *m_FrameStartPtr).count()/1000000.0);
-
-	// Sleep to reach the target frame time
-	if (elapsedTime < target) {
-		std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<long long>(target - elapsedTime)));
-	}
-
-	// Set start time for the next frame
-	*m_FrameStartPtr = std::chrono::steady_clock::now();
-
-#else
-
-	// Milliseconds elapsed
-	double elapsedTime = EndTiming();
-
-	// Sleep to reach the target frame time
-	if (elapsedTime < target)
-		Sleep((DWORD)(target - elapsedTime));
-
-	// Set start time for the next frame
-	StartTiming();
-
-#endif
-
-	// Reset Windows timer period
-	EndTimePeriod();
+	m_FramePacer.SetFps(static_cast<double>(fps));
+	m_FramePacer.Wait();
+}
 
+// -----------------------------------------------
+// Function: SetHoldSpin
+// Time before the HoldFps deadline to spin instead of sleep.
+//
+// Spin gives the most precise frame time at the cost of CPU
+// for that time. Default 0 - sleep only.
+void spoutFrameCount::SetHoldSpin(double msec)
+{
+	m_FramePacer.SetSpin(msec);
 }
 
 // -----------------------------------------------
@@ -503,9 +509,11 @@ void spoutFrameCount::SetNewFrame()
 			}
 			else {
 				// Increment the sender frame count
-				m_FrameCount++;
+				PublishFrame();
 				// Update the sender fps calculations for the new frame
-				UpdateSenderFps(1);
+				// if not timed by the control block
+				if (!m_bFramePublisher)
+					UpdateSenderFps(1);
 			}
 			return;
 		case WAIT_ABANDONED:
@@ -543,12 +551,90 @@ bool spoutFrameCount::GetNewFrame()
 	if (!m_bFrameCount || m_bCountDisabled)
 		return true;
 
-	// A receiver creates or opens a named semaphore when it connects to a sender
-	// Do not block if semaphore creation failed so that ReceiveTexture can still be called
-	if (!m_hCountSemaphore) {
+	// Frame number published by the sender in the control block.
+	// A single load instead of two kernel calls for the semaphore,
+	// and receivers do not change the count read by others.
+	// Compare the times with ProfileFrameCount.
+	const SpoutFrameControl* control = (const SpoutFrameControl*)m_FrameControl.Buffer();
+	LONG64 timestamp = 0;
+	if (control && control->id == SPOUT_FRAMECONTROL_ID) {
+		// Counts differ from the semaphore if the sender has changed
+		if (!m_bFrameControl) {
+			m_bFrameControl = true;
+			m_LastFrameCount = 0;
+		}
+		// The time is written before the frame number is incremented
+		// and can be the time of the next frame if read at the same time.
+		framecount = (long)control->frame;
+		timestamp = control->timestamp;
+	}
+	else {
+		if (m_bFrameControl) {
+			m_bFrameControl = false;
+			m_LastFrameCount = 0;
+		}
+		// A receiver creates or opens a named semaphore when it connects to a sender
+		// Do not block if semaphore creation failed so that ReceiveTexture can still be called
+		if (!m_hCountSemaphore) {
+			return true;
+		}
+		if (!ReadSemaphoreCount(framecount))
+			return true; // do not block
+	}
+
+	// Update the global frame count
+	m_FrameCount = framecount;
+
+	// Set a new frame by default, but test below and set false if this frame and the last are the same.
+	m_bIsNewFrame = true;
+
+	// Count will still be zero for apps that do not set a frame count
+	if (framecount == 0)
 		return true;
+
+	// If this count and the last are the same, the sender has not
+	// produced a new frame and incremented the counter.
+	// Return false if this frame and the last are the same.
+	if (framecount == m_LastFrameCount) {
+		m_bIsNewFrame = false;
+		return false;
 	}
 
+	// Sender time of the new frame
+	m_FrameTimestamp = timestamp;
+
+	// Let the sender know that this frame has been taken
+	if (m_bFrameControl)
+		AcknowledgeFrame(framecount);
+
+	//
+	// Update the sender fps calculations.
+	//
+	// The sender might have produced more than one frame if the receiver is slower.
+	// Pass the number of frames produced since the last. If m_LastFrameCount = 0, 
+	// the receiver has just started. Give it a frame to get the next frame count.
+	// Frames timed by the sender control block are added to the interval window.
+	if (m_bFrameControl) {
+		if (m_LastFrameCount > 0)
+			AddFrameInterval(timestamp, control->frequency, framecount - m_LastFrameCount);
+		else
+			m_LastTimestamp = timestamp;
+	}
+	else if(m_LastFrameCount > 0) {
+		UpdateSenderFps(framecount - m_LastFrameCount);
+	}
+
+	m_LastFrameCount = framecount;
+
+	return true;
+
+}
+
+// -----------------------------------------------
+// Read the frame count semaphore.
+// Returns false if the semaphore could not be released.
+bool spoutFrameCount::ReadSemaphoreCount(long &framecount)
+{
 	// Access the frame count semaphore
 	// WaitForSingleObject decrements the semaphore's count by one.
 	const DWORD dwWaitResult = WaitForSingleObject(m_hCountSemaphore, 0);
@@ -561,7 +647,7 @@ bool spoutFrameCount::GetNewFrame()
 			// released and incremented it.
 			if (ReleaseSemaphore(m_hCountSemaphore, 1, &framecount) == false) {
 				SpoutLogError("spoutFrameCount::GetNewFrame - ReleaseSemaphore failed");
-				return true; // do not block
+				return false;
 			}
 			break;
 		case WAIT_ABANDONED :
@@ -573,38 +659,445 @@ bool spoutFrameCount::GetNewFrame()
 		default :
 			break;
 	}
+	return true;
+}
 
-	// Update the global frame count
-	m_FrameCount = framecount;
+// -----------------------------------------------
+// Sender increment the frame number in the control block
+// with the time of the frame and the current frame period.
+// The control block frame number continues if a sender
+// of the same name is re-started while receivers hold it open.
+void spoutFrameCount::PublishFrame()
+{
+	SpoutFrameControl* control = (SpoutFrameControl*)m_FrameControl.Buffer();
+	if (!control) {
+		m_FrameCount++;
+		return;
+	}
 
-	// Set a new frame by default, but test below and set false if this frame and the last are the same.
-	m_bIsNewFrame = true;
+	if (!m_bFramePublisher) {
+		control->frequency = GetClockFrequency();
+		control->processId = (uint32_t)GetCurrentProcessId();
+		control->id = SPOUT_FRAMECONTROL_ID;
+		m_bFramePublisher = true;
+	}
 
-	// Count will still be zero for apps that do not set a frame count
-	if (framecount == 0)
-		return true;
+	const LONG64 timestamp = GetClockTicks();
+	AddFrameInterval(timestamp, control->frequency, 1);
+	InterlockedExchange64(&control->timestamp, timestamp);
+	if (m_SenderFps > 0.0)
+		InterlockedExchange64(&control->period, (LONG64)((double)control->frequency/m_SenderFps));
+	m_FrameCount = (long)InterlockedIncrement64(&control->frame);
+}
 
-	// If this count and the last are the same, the sender has not
-	// produced a new frame and incremented the counter.
-	// Return false if this frame and the last are the same.
-	if (framecount == m_LastFrameCount) {
-		m_bIsNewFrame = false;
+// -----------------------------------------------
+// The control block has receiver slots.
+// A block created by an earlier version has one page which
+// includes the slots, but check in case of a smaller map.
+bool spoutFrameCount::HasReceiverSlots()
+{
+	return (m_FrameControl.Buffer() && m_FrameControl.Size() >= (int)sizeof(SpoutFrameControl));
+}
+
+// -----------------------------------------------
+// Receiver record the frame taken in a slot of the control block.
+// A free slot is claimed with the first frame.
+void spoutFrameCount::AcknowledgeFrame(LONG64 framenumber)
+{
+	if (m_bFramePublisher || !HasReceiverSlots())
+		return;
+
+	SpoutFrameControl* control = (SpoutFrameControl*)m_FrameControl.Buffer();
+	const LONG64 now = GetClockTicks();
+	const LONG64 stale = control->frequency*SPOUT_RECEIVER_STALE/1000;
+
+	// Only the owner writes the slot time. If it has changed, another
+	// receiver has reclaimed the slot after this one stopped acknowledging.
+	if (m_ReceiverSlot >= 0) {
+		SpoutReceiverSlot& slot = control->receivers[m_ReceiverSlot];
+		if (InterlockedCompareExchange64(&slot.timestamp, now, m_SlotTimestamp) == m_SlotTimestamp) {
+			m_SlotTimestamp = now;
+			InterlockedExchange64(&slot.frame, framenumber);
+			return;
+		}
+		m_ReceiverSlot = -1;
+	}
+
+	// All slots were taken by the last search
+	if (m_SlotScanTime != 0 && (now - m_SlotScanTime) < stale)
+		return;
+
+	const LONG pid = (LONG)GetCurrentProcessId();
+	for (int i = 0; i < SPOUT_RECEIVER_SLOTS; i++) {
+		SpoutReceiverSlot& slot = control->receivers[i];
+		const LONG64 timestamp = slot.timestamp;
+		bool bClaimed = false;
+		if (InterlockedCompareExchange(&slot.processId, pid, 0) == 0) {
+			// Free slot. The time is zero after release,
+			// so others do not take it before the time is written.
+			bClaimed = true;
+		}
+		else if ((timestamp != 0 && (now - timestamp) >= stale)
+			|| (timestamp == 0 && IsReceiverProcessExited((DWORD)slot.processId))) {
+			// Reclaim the slot of a receiver that stopped acknowledging frames,
+			// or closed without release. The time is compared so that only
+			// one receiver can take it, including another in this process.
+			if (InterlockedCompareExchange64(&slot.timestamp, now, timestamp) == timestamp) {
+				InterlockedExchange(&slot.processId, pid);
+				bClaimed = true;
+			}
+		}
+		if (bClaimed) {
+			InterlockedExchange64(&slot.timestamp, now);
+			InterlockedExchange64(&slot.frame, framenumber);
+			InterlockedExchange(&slot.lockstep, m_bLockStep ? 1 : 0);
+			m_ReceiverSlot = i;
+			m_SlotTimestamp = now;
+			m_SlotScanTime = 0;
+			return;
+		}
+	}
+
+	// All slots taken - search again after SPOUT_RECEIVER_STALE
+	m_SlotScanTime = now;
+}
+
+// -----------------------------------------------
+// The process of a receiver slot has exited
+static bool IsReceiverProcessExited(DWORD dwProcId)
+{
+	if (dwProcId == 0)
 		return false;
+
+	HANDLE hProc = OpenProcess(SYNCHRONIZE, FALSE, dwProcId);
+	if (!hProc) {
+		// Access can be denied for another user or elevated process
+		// but the process ID is invalid if it has exited
+		return (GetLastError() == ERROR_INVALID_PARAMETER);
 	}
+	const bool bExited = (WaitForSingleObject(hProc, 0) != WAIT_TIMEOUT);
+	CloseHandle(hProc);
+	return bExited;
+}
 
-	//
-	// Update the sender fps calculations.
-	//
-	// The sender might have produced more than one frame if the receiver is slower.
-	// Pass the number of frames produced since the last. If m_LastFrameCount = 0, 
-	// the receiver has just started. Give it a frame to get the next frame count.
-	if(m_LastFrameCount > 0)
-		UpdateSenderFps(framecount - m_LastFrameCount);
+// -----------------------------------------------
+// Receiver free the control block slot
+void spoutFrameCount::ReleaseReceiverSlot()
+{
+	if (m_ReceiverSlot >= 0 && HasReceiverSlots()) {
+		SpoutReceiverSlot& slot = ((SpoutFrameControl*)m_FrameControl.Buffer())->receivers[m_ReceiverSlot];
+		// Release only if this receiver still owns the slot.
+		// The time is zeroed first so that the slot is free with zero time.
+		if (InterlockedCompareExchange64(&slot.timestamp, 0, m_SlotTimestamp) == m_SlotTimestamp) {
+			InterlockedExchange(&slot.lockstep, 0);
+			InterlockedExchange64(&slot.frame, 0);
+			InterlockedExchange(&slot.processId, 0);
+		}
+	}
+	m_ReceiverSlot = -1;
+	m_SlotTimestamp = 0;
+	m_SlotScanTime = 0;
+}
 
-	m_LastFrameCount = framecount;
+// -----------------------------------------------
+// Function: GetFrameControl
+// Sender frame control block.
+//
+// Copy of the frame number, time and period published by the sender.
+// Returns false if the sender does not publish the control block.
+bool spoutFrameCount::GetFrameControl(SpoutFrameControl* control)
+{
+	if (!control)
+		return false;
+
+	const SpoutFrameControl* pControl = (const SpoutFrameControl*)m_FrameControl.Buffer();
+	if (!pControl || pControl->id != SPOUT_FRAMECONTROL_ID)
+		return false;
+
+	*control = *pControl;
 
 	return true;
+}
+
+// -----------------------------------------------
+// Function: SetLockStep
+// Receiver - the sender waits for this receiver to take each frame
+// if the sender has set a wait time with SetReceiverWait.
+//
+// For recording, so that every frame is received. Live receivers
+// without lock-step are not waited for.
+void spoutFrameCount::SetLockStep(bool bLockStep)
+{
+	m_bLockStep = bLockStep;
+	if (m_ReceiverSlot >= 0 && HasReceiverSlots()) {
+		SpoutFrameControl* control = (SpoutFrameControl*)m_FrameControl.Buffer();
+		InterlockedExchange(&control->receivers[m_ReceiverSlot].lockstep, bLockStep ? 1 : 0);
+	}
+}
+
+// -----------------------------------------------
+// Function: SetReceiverWait
+// Sender - time to wait for lock-step receivers before each frame (msec).
+// Default 0 - do not wait.
+void spoutFrameCount::SetReceiverWait(DWORD dwTimeout)
+{
+	m_ReceiverWait = dwTimeout;
+}
+
+// -----------------------------------------------
+// Function: WaitReceivers
+// Sender - wait for lock-step receivers to take the last frame.
+//
+// Called before the shared texture is updated.
+// Receivers that have not acknowledged a frame for SPOUT_RECEIVER_STALE
+// are not waited for. Returns false if the wait timed out.
+bool spoutFrameCount::WaitReceivers()
+{
+	if (m_ReceiverWait == 0 || !m_bFramePublisher || !HasReceiverSlots())
+		return true;
+
+	const SpoutFrameControl* control = (const SpoutFrameControl*)m_FrameControl.Buffer();
+	const LONG64 framenumber = control->frame;
+	const LONG64 stale = control->frequency*SPOUT_RECEIVER_STALE/1000;
+	const LONG64 timeout = control->frequency*(LONG64)m_ReceiverWait/1000;
+	const LONG64 spin = control->frequency/1000; // 1 msec
+
+	const LONG64 start = GetClockTicks();
+	LONG64 now = start;
+	do {
+		bool bReady = true;
+		for (int i = 0; i < SPOUT_RECEIVER_SLOTS; i++) {
+			const SpoutReceiverSlot& slot = control->receivers[i];
+			if (slot.processId != 0 && slot.lockstep != 0
+				&& (now - slot.timestamp) < stale
+				&& slot.frame < framenumber) {
+				bReady = false;
+				break;
+			}
+		}
+		if (bReady)
+			return true;
+		// Yield for the first millisecond, then sleep
+		if ((now - start) < spin && !IsTestClock())
+			SwitchToThread();
+		else
+			ClockSleep(1);
+		now = GetClockTicks();
+	} while ((now - start) < timeout);
+
+	return false;
+}
+
+// -----------------------------------------------
+// Function: GetReceiverLag
+// Frames behind the sender for each receiver with a slot.
+//
+// Receivers that have not acknowledged a frame for SPOUT_RECEIVER_STALE
+// are not included.
+// Returns the number of receivers. Lag is filled for up to maxreceivers.
+// The sender or any receiver can check.
+int spoutFrameCount::GetReceiverLag(long* lag, int maxreceivers)
+{
+	if (!HasReceiverSlots())
+		return 0;
+
+	const SpoutFrameControl* control = (const SpoutFrameControl*)m_FrameControl.Buffer();
+	if (control->id != SPOUT_FRAMECONTROL_ID)
+		return 0;
+
+	const LONG64 framenumber = control->frame;
+	const LONG64 stale = control->frequency*SPOUT_RECEIVER_STALE/1000;
+	const LONG64 now = GetClockTicks();
+	int receivers = 0;
+	for (int i = 0; i < SPOUT_RECEIVER_SLOTS; i++) {
+		if (control->receivers[i].processId != 0
+			&& (now - control->receivers[i].timestamp) < stale) {
+			if (lag && receivers < maxreceivers)
+				lag[receivers] = (long)(framenumber - control->receivers[i].frame);
+			receivers++;
+		}
+	}
+	return receivers;
+}
+
+// -----------------------------------------------
+// Function: GetFrameStats
+// Sender frame rate statistics.
+//
+// Calculated from the sender times of the frames in the interval window.
+// The sender must publish the frame control block. A sender has
+// statistics for the frames it has sent and a receiver for those received.
+//
+// fps      - mean frames per second including dropped frames
+// interval - median frame interval (msec)
+// jitter95 - 95th percentile difference from the median interval (msec)
+// jitter99 - 99th percentile difference from the median interval (msec)
+// dropped  - frames not produced by the sender at the median interval
+// missed   - sender frames not received
+// frames   - number of intervals
+//
+bool spoutFrameCount::GetFrameStats(SpoutFrameStats& stats)
+{
+	ZeroMemory(&stats, sizeof(SpoutFrameStats));
+
+	const size_t n = m_pFrameIntervals->size();
+	if (n == 0)
+		return false;
+
+	double total = 0.0;
+	long spans = 0;
+	for (size_t i = 0; i < n; i++) {
+		total += (*m_pFrameIntervals)[i]*(double)(*m_pFrameSpans)[i];
+		spans += (*m_pFrameSpans)[i];
+	}
+	if (total <= 0.0)
+		return false;
+	stats.fps = 1000.0*(double)spans/total;
+
+	std::vector<double> intervals(*m_pFrameIntervals);
+	std::sort(intervals.begin(), intervals.end());
+	stats.interval = intervals[n/2];
+
+	for (size_t i = 0; i < n; i++)
+		intervals[i] = fabs((*m_pFrameIntervals)[i] - stats.interval);
+	std::sort(intervals.begin(), intervals.end());
+	stats.jitter95 = intervals[(size_t)ceil(0.95*(double)n) - 1];
+	stats.jitter99 = intervals[(size_t)ceil(0.99*(double)n) - 1];
+
+	for (size_t i = 0; i < n; i++) {
+		const long span = (*m_pFrameSpans)[i];
+		if (stats.interval > 0.0) {
+			const long expected = (long)floor((*m_pFrameIntervals)[i]*(double)span/stats.interval + 0.5);
+			if (expected > span)
+				stats.dropped += (int)(expected - span);
+		}
+		stats.missed += (int)(span - 1);
+	}
+	stats.frames = (int)n;
+
+	return true;
+}
+
+// -----------------------------------------------
+// Function: SetFpsWindow
+// Number of frame intervals for statistics.
+//
+// A longer window gives more stable statistics.
+// The window restarts after SPOUT_FPS_SETTLE frames
+// at a different rate so the fps settles quickly.
+void spoutFrameCount::SetFpsWindow(int frames)
+{
+	if (frames < SPOUT_FPS_SETTLE)
+		frames = SPOUT_FPS_SETTLE;
+	m_FpsWindow = frames;
+	while ((int)m_pFrameIntervals->size() > m_FpsWindow) {
+		m_pFrameIntervals->erase(m_pFrameIntervals->begin());
+		m_pFrameSpans->erase(m_pFrameSpans->begin());
+	}
+}
+
+// -----------------------------------------------
+// Function: GetFpsWindow
+// Number of frame intervals for statistics.
+int spoutFrameCount::GetFpsWindow()
+{
+	return m_FpsWindow;
+}
+
+// -----------------------------------------------
+// Add the sender time of a frame to the interval window
+// and update the sender fps.
+// frames is the number of sender frames since the last.
+void spoutFrameCount::AddFrameInterval(LONG64 timestamp, LONG64 frequency, long frames)
+{
+	if (frames <= 0 || frequency <= 0 || m_bCountDisabled)
+		return;
+
+	if (m_LastTimestamp == 0 || timestamp <= m_LastTimestamp) {
+		m_LastTimestamp = timestamp;
+		return;
+	}
+
+	const double interval = (double)(timestamp - m_LastTimestamp)*1000.0/(double)frequency/(double)frames;
+	m_LastTimestamp = timestamp;
+
+	// Count successive intervals at a different rate
+	if (m_SenderFps > 0.0) {
+		const double period = 1000.0/m_SenderFps;
+		if (interval > period*1.25 || interval < period*0.8)
+			m_RateChange++;
+		else
+			m_RateChange = 0;
+	}
+
+	m_pFrameIntervals->push_back(interval);
+	m_pFrameSpans->push_back(frames);
+
+	// Restart the window with the intervals at the new rate
+	int window = m_FpsWindow;
+	if (m_RateChange >= SPOUT_FPS_SETTLE) {
+		window = SPOUT_FPS_SETTLE;
+		m_RateChange = 0;
+	}
+	if ((int)m_pFrameIntervals->size() > window) {
+		const size_t excess = m_pFrameIntervals->size() - (size_t)window;
+		m_pFrameIntervals->erase(m_pFrameIntervals->begin(), m_pFrameIntervals->begin() + excess);
+		m_pFrameSpans->erase(m_pFrameSpans->begin(), m_pFrameSpans->begin() + excess);
+	}
+
+	// Mean fps of the window
+	double total = 0.0;
+	long spans = 0;
+	for (size_t i = 0; i < m_pFrameIntervals->size(); i++) {
+		total += (*m_pFrameIntervals)[i]*(double)(*m_pFrameSpans)[i];
+		spans += (*m_pFrameSpans)[i];
+	}
+	if (total > 0.0)
+		m_SenderFps = 1000.0*(double)spans/total;
+}
 
+// -----------------------------------------------
+// Clear the frame interval window
+void spoutFrameCount::ResetFrameIntervals()
+{
+	m_pFrameIntervals->clear();
+	m_pFrameSpans->clear();
+	m_RateChange = 0;
+	m_LastTimestamp = 0;
+}
+
+// -----------------------------------------------
+// Function: ProfileFrameCount
+// Time frame count queries by semaphore and control block.
+//
+// Returns the average time for each query in microseconds.
+// A receiver must be connected to a sender with frame counting enabled.
+// The semaphore count is not changed.
+bool spoutFrameCount::ProfileFrameCount(double &semaphoreTime, double &controlTime, int iterations)
+{
+	semaphoreTime = 0.0;
+	controlTime = 0.0;
+
+	const SpoutFrameControl* control = (const SpoutFrameControl*)m_FrameControl.Buffer();
+	if (!m_hCountSemaphore || !control || iterations <= 0)
+		return false;
+
+	long framecount = 0;
+	LONG64 start = GetClockTicks();
+	for (int i = 0; i < iterations; i++)
+		ReadSemaphoreCount(framecount);
+	semaphoreTime = ClockTicksToMilliseconds(GetClockTicks() - start)*1000.0/(double)iterations;
+
+	LONG64 frame = 0;
+	start = GetClockTicks();
+	for (int i = 0; i < iterations; i++)
+		frame += control->frame;
+	controlTime = ClockTicksToMilliseconds(GetClockTicks() - start)*1000.0/(double)iterations;
+
+	SpoutLogNotice("spoutFrameCount::ProfileFrameCount - semaphore %.3f usec, control block %.3f usec (%d queries)",
+		semaphoreTime, controlTime, iterations);
+
+	return true;
 }
 
 // -----------------------------------------------
@@ -620,6 +1113,15 @@ void spoutFrameCount::CleanupFrameCount()
 		if (m_hCountSemaphore) CloseHandle(m_hCountSemaphore);
 		m_hCountSemaphore = NULL;
 
+		// Close the frame control block. A sender lets receivers
+		// that hold it open know that the count has stopped.
+		ReleaseReceiverSlot();
+		if (m_bFramePublisher && m_FrameControl.Buffer())
+			((SpoutFrameControl*)m_FrameControl.Buffer())->id = 0;
+		m_FrameControl.Close();
+		m_bFramePublisher = false;
+		m_bFrameControl = false;
+
 		// Close the texture access mutex
 		if (m_hAccessMutex) CloseHandle(m_hAccessMutex);
 		m_hAccessMutex = NULL;
@@ -633,11 +1135,13 @@ void spoutFrameCount::CleanupFrameCount()
 
 		// Reset counters
 		m_FrameCount = 0L;
+		m_FrameTimestamp = 0;
 		m_LastFrameCount = 0L;
 		m_FrameTime = 0.0;
 		m_FrameTimeTotal = 0.0;
 		m_FrameTimeNumber = 0.0;
 		m_SenderFps = m_SystemFps; // Default sender fps is system refresh rate
+		ResetFrameIntervals();
 	}
 	catch (...) {
 		SpoutLogError("SpoutFrameCount::CleanupFrameCount caused an exception");
@@ -749,6 +1253,9 @@ bool spoutFrameCount::CreateAccessMutex(const char *SenderName)
 	// Save the handle for access
 	m_hAccessMutex = hMutex;
 
+	// Statistics for this connection
+	ResetAccessStats();
+
 	return true;
 
 }
@@ -772,7 +1279,8 @@ void spoutFrameCount::CloseAccessMutex()
 //
 // Check whether any other process is holding the lock.
 //
-// Wait for access for up to 4 frames if so.
+// Wait for access for up to 4 frames if so,
+// or the time set by SetAccessTimeout.
 //
 // If receiving from Spout 1 apps with no mutex lock,
 // a reader will have created the mutex and will have
@@ -792,7 +1300,9 @@ bool spoutFrameCount::CheckAccess()
 	// Note that NVIDIA "Threaded optimization" can cause a delay for WaitForSingleObject
 	// and can be set OFF by the NVIDIA control panel or by SpoutSettings.
 	//
-	const DWORD dwWaitResult = WaitForSingleObject(m_hAccessMutex, 67); // timeout 4 frames at 60fps
+	const LONG64 start = GetClockTicks();
+	const DWORD dwWaitResult = WaitForSingleObject(m_hAccessMutex, m_AccessTimeout); // default 4 frames at 60fps
+	AddAccessWait(start, dwWaitResult);
 	switch (dwWaitResult) {
 		case WAIT_OBJECT_0 : // 0
 			// The state of the object is signalled.
@@ -835,6 +1345,48 @@ void spoutFrameCount::AllowAccess()
 
 }
 
+// -----------------------------------------------
+// Function: SetAccessTimeout
+// Set the time to wait for texture access (msec).
+//
+// Default 67 msec - 4 frames at 60fps.
+// Zero tries once and returns immediately if the sender
+// holds the texture. A receiver can then use the last frame
+// instead of waiting for the sender.
+void spoutFrameCount::SetAccessTimeout(DWORD dwTimeout)
+{
+	m_AccessTimeout = dwTimeout;
+}
+
+// -----------------------------------------------
+// Function: GetAccessTimeout
+// Get the time to wait for texture access (msec)
+DWORD spoutFrameCount::GetAccessTimeout()
+{
+	return m_AccessTimeout;
+}
+
+// -----------------------------------------------
+// Function: GetAccessStats
+// Texture access waits since the access mutex was opened.
+//
+// Number of checks, timeouts, abandoned and failed waits,
+// total and longest wait time and a histogram of wait times.
+// Returns false if there have been no checks.
+bool spoutFrameCount::GetAccessStats(SpoutAccessStats& stats)
+{
+	stats = m_AccessStats;
+	return (m_AccessStats.waits > 0);
+}
+
+// -----------------------------------------------
+// Function: ResetAccessStats
+// Clear texture access statistics
+void spoutFrameCount::ResetAccessStats()
+{
+	m_AccessStats = {};
+}
+
 // -----------------------------------------------
 // Function: IsKeyedMutex
 // Test for keyed mutex
@@ -936,6 +1488,80 @@ bool spoutFrameCount::WaitFrameSync(const char *sendername, DWORD dwTimeout)
 }
 
 
+// -----------------------------------------------
+// Function: CanWaitNewFrame
+// The sender frame number can be tested by WaitNewFrame.
+//
+// False if frame counting is disabled, the count has not been read yet,
+// or the sender does not publish a frame control block or semaphore.
+// WaitNewFrame then returns immediately and the receiver should keep
+// its own frame rate.
+bool spoutFrameCount::CanWaitNewFrame()
+{
+	if (!m_bFrameCount || m_bCountDisabled || m_LastFrameCount == 0)
+		return false;
+
+	if (m_bFrameControl) {
+		const SpoutFrameControl* control = (const SpoutFrameControl*)m_FrameControl.Buffer();
+		return (control && control->id == SPOUT_FRAMECONTROL_ID);
+	}
+
+	return (m_hCountSemaphore != NULL);
+}
+
+// -----------------------------------------------
+// Function: WaitNewFrame
+// Wait for the connected sender to produce a new frame.
+//
+// Used by a receiver instead of polling at a fixed rate.
+// Test the frame number at 1 msec intervals until it changes
+// or the timeout elapses. The frame number is read from the frame control
+// block if the sender publishes it, or from the frame count semaphore
+// for earlier senders, the same as GetNewFrame.
+// The frame count comparator is not changed. GetNewFrame is still
+// used within the texture access lock to read the frame.
+//
+// The sender sync event is not used. It is auto-reset and signals
+// a sender waiting in WaitFrameSync, so a receiver wait would take
+// the signal from it, and only one of several receivers would be released.
+//
+// Returns true if a new frame is ready or frame status cannot be detected
+// (see CanWaitNewFrame), false if the timeout elapsed without a new frame.
+bool spoutFrameCount::WaitNewFrame(const char* sendername, DWORD dwTimeout)
+{
+	// Do not block if the frame number cannot be tested
+	if (!sendername || !*sendername || !CanWaitNewFrame())
+		return true;
+
+	const SpoutFrameControl* control = (const SpoutFrameControl*)m_FrameControl.Buffer();
+
+	const LONG64 start = GetClockTicks();
+	const LONG64 timeout = MillisecondsToClockTicks(static_cast<double>(dwTimeout));
+	do {
+		if (m_bFrameControl) {
+			// A single load, no kernel calls
+			if (control->id != SPOUT_FRAMECONTROL_ID || (long)control->frame != m_LastFrameCount)
+				return true;
+		}
+		else {
+			// Record the current count without changing it.
+			// The sender might hold the count while incrementing it,
+			// so a failed wait is tested again next time round.
+			long framecount = 0;
+			if (WaitForSingleObject(m_hCountSemaphore, 0) == WAIT_OBJECT_0) {
+				if (ReleaseSemaphore(m_hCountSemaphore, 1, &framecount) == false)
+					return true;
+				if (framecount != m_LastFrameCount)
+					return true;
+			}
+		}
+		ClockSleep(1);
+	} while (GetClockTicks() - start < timeout);
+
+	return false;
+
+}
+
 // -----------------------------------------------
 // Function: CloseFrameSync
 // Close event for sync to frame rate.
@@ -977,7 +1603,9 @@ bool spoutFrameCount::CheckKeyedAccess(ID3D11Texture2D* pTexture)
 		// Check the keyed mutex
 		pTexture->QueryInterface(__uuidof(IDXGIKeyedMutex), (void**)&pDXGIKeyedMutex); // PR#81
 		if (pDXGIKeyedMutex) {
-			const HRESULT hr = pDXGIKeyedMutex->AcquireSync(0, 67);
+			const LONG64 start = GetClockTicks();
+			const HRESULT hr = pDXGIKeyedMutex->AcquireSync(0, m_AccessTimeout);
+			AddAccessWait(start, (hr == S_OK) ? WAIT_OBJECT_0 : static_cast<DWORD>(hr));
 			switch (hr) {
 				case S_OK:
 					// Sync was acquired
@@ -991,7 +1619,9 @@ bool spoutFrameCount::CheckKeyedAccess(ID3D11Texture2D* pTexture)
 				case static_cast<HRESULT>(WAIT_TIMEOUT):
 					// The time-out interval elapsed before the key was released.
 					// Can't access the shared texture right now, try again later
-					SpoutLogError("spoutDirectX::CheckKeyedAccess : WAIT_TIMEOUT");
+					// Expected without waiting, so logged only for a timeout.
+					if (m_AccessTimeout > 0)
+						SpoutLogError("spoutDirectX::CheckKeyedAccess : WAIT_TIMEOUT");
 					break;
 				case E_FAIL:
 					// If the owning device attempted to create another keyed mutex 
@@ -1027,6 +1657,40 @@ bool spoutFrameCount::AllowKeyedAccess(ID3D11Texture2D* pTexture)
 }
 
 
+// -----------------------------------------------
+// Record the time and result of a texture access wait
+void spoutFrameCount::AddAccessWait(LONG64 start, DWORD dwResult)
+{
+	const double wait = ClockTicksToMilliseconds(GetClockTicks() - start)*1000.0;
+
+	m_AccessStats.waits++;
+	m_AccessStats.totalwait += wait;
+	if (wait > m_AccessStats.maxwait)
+		m_AccessStats.maxwait = wait;
+
+	int bin = 0;
+	double limit = 10.0;
+	while (bin < SPOUT_ACCESS_BINS-1 && wait >= limit) {
+		bin++;
+		limit *= 10.0;
+	}
+	m_AccessStats.histogram[bin]++;
+
+	switch (dwResult) {
+		case WAIT_OBJECT_0:
+			break;
+		case WAIT_TIMEOUT:
+			m_AccessStats.timeouts++;
+			break;
+		case WAIT_ABANDONED:
+			m_AccessStats.abandoned++;
+			break;
+		default:
+			m_AccessStats.failed++;
+			break;
+	}
+}
+
 // -----------------------------------------------
 // Calculate the sender frames per second
 // Applications before 2.007 have a frame rate dependent on the system fps
@@ -1038,19 +1702,11 @@ void spoutFrameCount::UpdateSenderFps(long framecount)
 	// If framecount is zero, the sender has not produced a new frame yet
 	if (framecount > 0) {
 
-		
-#ifdef USE_CHRONO
 		// End time since last call
-		*m_FpsEndPtr = std::chrono::steady_clock::now();
-		// Msecs between this frame and the last
-		m_FrameTime = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(*m_FpsEndPtr - *m_FpsStartPtr).count()/1000000.0);
-#else
-		// End time since last call
-		double thisFrame = GetCounter();
+		const double thisFrame = ClockTicksToMilliseconds(GetClockTicks());
 		// Msecs between this frame and the last
 		m_FrameTime = thisFrame - m_lastFrame;
-#endif
-		
+
 		if (m_FrameTime > 1.0) { // > 1 msec
 
 			// Frame time in seconds 
@@ -1077,51 +1733,15 @@ void spoutFrameCount::UpdateSenderFps(long framecount)
 
 		}
 
-// Set the start time for the next frame
-#ifdef USE_CHRONO
-		*m_FpsStartPtr = std::chrono::steady_clock::now();
-#else
+		// Set the start time for the next frame
 		m_lastFrame = thisFrame;
-#endif
 
 	}
 	else {
-
-#ifdef USE_CHRONO
 		// If framecount is zero, the sender has not produced a new frame yet
-		*m_FpsStartPtr = std::chrono::steady_clock::now();
-		*m_FpsEndPtr = std::chrono::steady_clock::now();
-#endif
-
-	}
-
-}
-
-
-// -----------------------------------------------
-// Reduce Windows timing period to the minimum
-// supported by the system (usually 1 msec)
-void spoutFrameCount::StartTimePeriod()
-{
-	TIMECAPS tc={};
-	m_PeriodMin = 0; // To allow for errors
-	MMRESULT mres = timeGetDevCaps(&tc, sizeof(TIMECAPS));
-	if (mres == MMSYSERR_NOERROR) {
-		mres = timeBeginPeriod(tc.wPeriodMin);
-		if (mres == TIMERR_NOERROR)
-			m_PeriodMin = tc.wPeriodMin;
+		m_lastFrame = ClockTicksToMilliseconds(GetClockTicks());
 	}
-}
 
-
-// -----------------------------------------------
-// Reset Windows timing period
-void spoutFrameCount::EndTimePeriod()
-{
-	if (m_PeriodMin > 0) {
-		timeEndPeriod(m_PeriodMin);
-		m_PeriodMin = 0;
-	}
 }
 
 
@@ -1216,3 +1836,160 @@ bool spoutFrameCount::IsFrameSyncEnabled()
 // ===============================================================================
 
 
+// ===============================================================================
+//
+// spoutFramePacer
+//
+// ===============================================================================
+
+// -----------------------------------------------
+spoutFramePacer::spoutFramePacer()
+{
+	m_Fps = 0.0;
+	m_Period = 0.0;
+	m_Start = 0;
+	m_Frame = -1;
+	m_Spin = 0;
+	m_Missed = 0LL;
+	m_PeriodMin = 0;
+	m_Frequency = GetClockFrequency();
+}
+
+// -----------------------------------------------
+spoutFramePacer::~spoutFramePacer()
+{
+	EndTimePeriod();
+}
+
+// -----------------------------------------------
+// Set the frame rate
+void spoutFramePacer::SetFps(double fps)
+{
+	if (fps <= 0.0 || (fps == m_Fps && m_Frequency == GetClockFrequency()))
+		return;
+	m_Fps = fps;
+	m_Frequency = GetClockFrequency();
+	m_Period = static_cast<double>(m_Frequency)/fps;
+	Reset();
+}
+
+// -----------------------------------------------
+// Get the frame rate
+double spoutFramePacer::GetFps()
+{
+	return m_Fps;
+}
+
+// -----------------------------------------------
+// Milliseconds before the deadline to spin instead of sleep
+void spoutFramePacer::SetSpin(double msec)
+{
+	if (msec < 0.0) msec = 0.0;
+	m_Spin = static_cast<LONG64>(msec*static_cast<double>(m_Frequency)/1000.0);
+}
+
+// -----------------------------------------------
+// Wait until the next frame deadline.
+// Returns false if the deadline was missed.
+bool spoutFramePacer::Wait()
+{
+	if (m_Period <= 0.0)
+		return false;
+
+	// Reduce Windows timer period to minimum for the life of the object
+	if (m_PeriodMin == 0)
+		StartTimePeriod();
+
+	LONG64 now = GetClockTicks();
+
+	// The first deadline is the current time
+	if (m_Frame < 0) {
+		m_Start = now;
+		m_Frame = 0;
+		return true;
+	}
+
+	// Deadline from the start in whole periods, so errors do not accumulate
+	m_Frame++;
+	const LONG64 deadline = m_Start + static_cast<LONG64>(static_cast<double>(m_Frame)*m_Period);
+
+	// Late. Keep the schedule if less than two periods late
+	// so the next frame makes up the time, otherwise restart.
+	if (now >= deadline) {
+		if (static_cast<double>(now - deadline) > m_Period*2.0) {
+			m_Start = now;
+			m_Frame = 0;
+			m_Missed++;
+		}
+		return false;
+	}
+
+	// Sleep only. Round to the nearest millisecond.
+	// The error is taken up by the next deadline.
+	if (m_Spin == 0) {
+		const DWORD dwSleep = static_cast<DWORD>(((deadline - now)*1000 + m_Frequency/2)/m_Frequency);
+		if (dwSleep > 0)
+			ClockSleep(dwSleep);
+		return true;
+	}
+
+	// Sleep whole milliseconds to the spin time
+	const LONG64 sleeptime = deadline - now - m_Spin;
+	if (sleeptime > 0) {
+		const DWORD dwSleep = static_cast<DWORD>((sleeptime*1000)/m_Frequency);
+		if (dwSleep > 0)
+			ClockSleep(dwSleep);
+	}
+
+	// Spin to the deadline
+	// The test clock moves to the deadline instead
+	now = GetClockTicks();
+	if (IsTestClock() && now < deadline)
+		AdvanceTestClock(deadline - now);
+	while (now < deadline) {
+		YieldProcessor();
+		now = GetClockTicks();
+	}
+
+	return true;
+}
+
+// -----------------------------------------------
+// Restart the deadlines from the next wait
+void spoutFramePacer::Reset()
+{
+	m_Start = 0;
+	m_Frame = -1;
+}
+
+// -----------------------------------------------
+// Number of deadlines that restarted the schedule
+long long spoutFramePacer::GetMissed()
+{
+	return m_Missed;
+}
+
+// -----------------------------------------------
+// Reduce Windows timing period to the minimum
+// supported by the system (usually 1 msec)
+void spoutFramePacer::StartTimePeriod()
+{
+	TIMECAPS tc={};
+	m_PeriodMin = 0; // To allow for errors
+	MMRESULT mres = timeGetDevCaps(&tc, sizeof(TIMECAPS));
+	if (mres == MMSYSERR_NOERROR) {
+		mres = timeBeginPeriod(tc.wPeriodMin);
+		if (mres == TIMERR_NOERROR)
+			m_PeriodMin = tc.wPeriodMin;
+	}
+}
+
+// -----------------------------------------------
+// Reset Windows timing period
+void spoutFramePacer::EndTimePeriod()
+{
+	if (m_PeriodMin > 0) {
+		timeEndPeriod(m_PeriodMin);
+		m_PeriodMin = 0;
+	}
+}
@@ -36,18 +36,128 @@
 
 #include <string>
 #include <vector>
+#include <algorithm> // for sort
 #include <d3d11.h>
 #pragma comment (lib, "d3d11.lib") // for keyed mutex texture access
 #pragma comment (lib, "Winmm.lib") // for timer resolution functions 
 
 using namespace spoututils;
 
-// USE_CHRONO is defined in SpoutUtils.h
-// Note comments about using an early platform toolset
-#ifdef USE_CHRONO
-#include <chrono> // c++11 timer
-#include <thread>
-#endif
+//
+// Frame control block "<sender>_Count_Control"
+//
+// Published by the sender for each frame together with the frame count
+// semaphore, which is retained for earlier versions. Receivers read the
+// frame number with a plain load instead of waiting on and releasing the
+// semaphore. The timestamp is written before the frame number is incremented.
+//
+#define SPOUT_FRAMECONTROL_ID 0x314B5053 // "SPK1" - sender publishing
+
+// Receivers acknowledge each frame in a slot after the control block header.
+// A sender can wait for receivers that set lock-step before the next frame.
+//
+#define SPOUT_RECEIVER_SLOTS 8
+#define SPOUT_RECEIVER_STALE 1000 // msec without acknowledgement before a receiver is not waited for
+
+struct SpoutReceiverSlot {		// 32 bytes total
+	volatile LONG processId;	// 4 bytes : receiver process ID, zero if the slot is free
+	volatile LONG lockstep;		// 4 bytes : 1 if the sender should wait for this receiver
+	volatile LONG64 frame;		// 8 bytes : last frame received
+	volatile LONG64 timestamp;	// 8 bytes : QueryPerformanceCounter time of the acknowledgement
+	LONG64 reserved;			// 8 bytes : unused
+};
+
+struct SpoutFrameControl {		// 64 bytes header and receiver slots
+	uint32_t id;				// 4 bytes : SPOUT_FRAMECONTROL_ID, zero when the sender closes
+	uint32_t processId;			// 4 bytes : sender process ID
+	volatile LONG64 frame;		// 8 bytes : frame number
+	volatile LONG64 timestamp;	// 8 bytes : QueryPerformanceCounter time of the last frame
+	volatile LONG64 period;		// 8 bytes : nominal frame period in counter ticks
+	LONG64 frequency;			// 8 bytes : QueryPerformanceFrequency
+	uint32_t reserved[6];		// 24 bytes : unused
+	SpoutReceiverSlot receivers[SPOUT_RECEIVER_SLOTS]; // 256 bytes
+};
+
+//
+// Sender frame rate statistics over a window of frame intervals,
+// timed by the sender frame control block.
+//
+#define SPOUT_FPS_WINDOW 60 // Default number of frame intervals
+#define SPOUT_FPS_SETTLE 8  // Intervals at a different rate to restart the window
+
+struct SpoutFrameStats {
+	double fps;			// Mean frames per second
+	double interval;	// Median frame interval (msec)
+	double jitter95;	// 95th percentile difference from the median interval (msec)
+	double jitter99;	// 99th percentile difference from the median interval (msec)
+	int dropped;		// Frames not produced by the sender at the median interval
+	int missed;			// Sender frames not received
+	int frames;			// Number of intervals
+};
+
+//
+// Texture access waits for the connection.
+// Histogram bins are wait times less than 10, 100, 1000, 10000
+// and 100000 microseconds, and the remainder.
+//
+#define SPOUT_ACCESS_TIMEOUT 67 // Default wait (msec) - 4 frames at 60fps
+#define SPOUT_ACCESS_BINS 6
+
+struct SpoutAccessStats {
+	long long waits;		// Access checks
+	long long timeouts;		// Checks that timed out or found the texture busy
+	long long abandoned;	// Checks that found the mutex abandoned
+	long long failed;		// Checks that failed for other reasons
+	double totalwait;		// Total wait time (microseconds)
+	double maxwait;			// Longest wait time (microseconds)
+	long long histogram[SPOUT_ACCESS_BINS];
+};
+
+//
+// Frame pacing to absolute deadlines.
+//
+// Deadlines are counted from a start time in whole frame periods,
+// so sleep errors do not accumulate. A frame that is late is not
+// delayed further and the next deadline is unchanged. If more than
+// two periods late, the deadlines restart from the current time.
+// Sleep is followed by an optional spin for the last milliseconds.
+// The Windows timer period is set to the minimum from the first wait
+// until the object is destroyed.
+//
+class SPOUT_DLLEXP spoutFramePacer {
+
+	public:
+
+	spoutFramePacer();
+	~spoutFramePacer();
+
+	// Set the frame rate. The deadlines restart if it changes.
+	void SetFps(double fps);
+	// Get the frame rate
+	double GetFps();
+	// Milliseconds before the deadline to spin instead of sleep (0 - sleep only)
+	void SetSpin(double msec);
+	// Wait until the next frame deadline. Returns false if it was missed.
+	bool Wait();
+	// Restart the deadlines from the next wait
+	void Reset();
+	// Number of deadlines that restarted the schedule
+	long long GetMissed();
+
+	protected:
+
+	double m_Fps;
+	double m_Period;		// frame period in counter ticks
+	LONG64 m_Frequency;		// Clock frequency
+	LONG64 m_Start;			// clock at the first deadline
+	LONG64 m_Frame;			// deadlines since the start, -1 before the first wait
+	LONG64 m_Spin;			// spin time in counter ticks
+	long long m_Missed;
+	UINT m_PeriodMin;		// Windows timer period set by the object
+	void StartTimePeriod();
+	void EndTimePeriod();
+
+};
 
 class SPOUT_DLLEXP spoutFrameCount {
 
@@ -76,8 +186,30 @@ class SPOUT_DLLEXP spoutFrameCount {
 	double GetSenderFps();
 	// Received frame count
 	long GetSenderFrame();
+	// Sender clock time of the received frame
+	LONG64 GetSenderFrameTime();
 	// Frame rate control
 	void HoldFps(int fps);
+	// Spin time before the HoldFps deadline (msec, 0 - sleep only)
+	void SetHoldSpin(double msec);
+	// Sender frame control block
+	bool GetFrameControl(SpoutFrameControl* control);
+	// Sender frame rate statistics
+	bool GetFrameStats(SpoutFrameStats& stats);
+	// Number of frame intervals for statistics
+	void SetFpsWindow(int frames = SPOUT_FPS_WINDOW);
+	// Get the number of frame intervals for statistics
+	int GetFpsWindow();
+	// Receiver - sender waits for this receiver to take each frame
+	void SetLockStep(bool bLockStep = true);
+	// Sender - time to wait for lock-step receivers (msec, 0 - do not wait)
+	void SetReceiverWait(DWORD dwTimeout);
+	// Sender - wait for lock-step receivers to take the last frame
+	bool WaitReceivers();
+	// Frames behind the sender for each receiver
+	int GetReceiverLag(long* lag, int maxreceivers);
+	// Time frame count queries by semaphore and control block (microseconds)
+	bool ProfileFrameCount(double &semaphoreTime, double &controlTime, int iterations = 1000);
 
 	//
 	// Used by other classes
@@ -115,6 +247,14 @@ class SPOUT_DLLEXP spoutFrameCount {
 	void AllowAccess();
 	// Test for keyed mutex
 	bool IsKeyedMutex(ID3D11Texture2D* D3D11texture);
+	// Set the texture access wait (msec, 0 - try once and return)
+	void SetAccessTimeout(DWORD dwTimeout = SPOUT_ACCESS_TIMEOUT);
+	// Get the texture access wait
+	DWORD GetAccessTimeout();
+	// Texture access waits since the mutex was opened
+	bool GetAccessStats(SpoutAccessStats& stats);
+	// Clear texture access statistics
+	void ResetAccessStats();
 
 	//
 	// Sync events
@@ -124,6 +264,10 @@ class SPOUT_DLLEXP spoutFrameCount {
 	void SetFrameSync(const char* name);
 	// Wait or test for a sync event
 	bool WaitFrameSync(const char *name, DWORD dwTimeout = 0);
+	// Wait for a new frame from the connected sender
+	bool WaitNewFrame(const char* name, DWORD dwTimeout);
+	// The sender frame number can be tested by WaitNewFrame
+	bool CanWaitNewFrame();
 	// Close sync event
 	void CloseFrameSync();
 	// Enable / disable frame sync
@@ -135,6 +279,9 @@ protected:
 
 	// Texture access named mutex
 	HANDLE m_hAccessMutex;
+	DWORD m_AccessTimeout;
+	SpoutAccessStats m_AccessStats;
+	void AddAccessWait(LONG64 start, DWORD dwResult);
 
 	// DX11 texture keyed mutex checks
 	bool CheckKeyedAccess(ID3D11Texture2D* D3D11texture);
@@ -149,40 +296,52 @@ protected:
 	char m_CountSemaphoreName[256]; // semaphore name
 	char m_SenderName[256]; // sender currently connected to a receiver
 	long m_FrameCount; // sender frame count
+	LONG64 m_FrameTimestamp; // sender clock time of the received frame
 	long m_LastFrameCount; // receiver frame comparator
 	double m_FrameTime;
 	double m_FrameTimeTotal;
 	double m_FrameTimeNumber;
 	double m_lastFrame;
 
+	// Frame control block
+	SpoutSharedMemory m_FrameControl;
+	bool m_bFrameControl; // receiver frame count from the control block
+	bool m_bFramePublisher; // sender writing the control block
+	void PublishFrame();
+	bool ReadSemaphoreCount(long &framecount);
+
+	// Receiver acknowledgement
+	int m_ReceiverSlot; // slot in the control block, -1 if none
+	LONG64 m_SlotTimestamp; // time last written to the slot
+	LONG64 m_SlotScanTime; // time of a search that found all slots taken
+	bool m_bLockStep;
+	DWORD m_ReceiverWait;
+	bool HasReceiverSlots();
+	void AcknowledgeFrame(LONG64 framenumber);
+	void ReleaseReceiverSlot();
+
+	// Frame interval window
+	std::vector<double>* m_pFrameIntervals; // Interval for each frame (msec)
+	std::vector<long>* m_pFrameSpans; // Sender frames for each interval
+	int m_FpsWindow;
+	int m_RateChange;
+	LONG64 m_LastTimestamp;
+	void AddFrameInterval(LONG64 timestamp, LONG64 frequency, long frames);
+	void ResetFrameIntervals();
+
 	// Sender frame timing
 	double m_SystemFps;
 	double m_SenderFps;
 	void UpdateSenderFps(long framecount = 0);
 
-	// Windows minimum time period
-	UINT m_PeriodMin;
-	void StartTimePeriod();
-	void EndTimePeriod();
+	// HoldFps frame pacing
+	spoutFramePacer m_FramePacer;
 
 	// Sync event
 	bool m_bFrameSync;
 	HANDLE m_hSyncEvent;
 	void OpenFrameSync(const char* SenderName);
 
-#ifdef USE_CHRONO
-
-	// Avoid C4251 warnings in SpoutLibrary by using pointers
-	// USE_CHRONO is defined in SpoutUtils.h
-	// Use of std::unique_ptr to avoid warning C26409 using new/delete
-	// results in warning C4251 needs to have dll-interface
-	std::chrono::steady_clock::time_point* m_FpsStartPtr;
-	std::chrono::steady_clock::time_point* m_FpsEndPtr;
-	std::chrono::steady_clock::time_point* m_FrameStartPtr;
-	std::chrono::steady_clock::time_point* m_FrameEndPtr;
-
-#endif
-
 };
 
 #endif
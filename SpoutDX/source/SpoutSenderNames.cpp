@@ -110,6 +110,35 @@
 	Version 2.007.014
 	20.06.24 - Add GetSenderIndex
 	23.08.24 - GetSenderInfo, SetSenderID - initialize SharedTextureInfo
+	18.10.26 - Sender information map extended with a change count and process ID.
+			   Add CheckSenderInfo/CloseSenderInfo for a receiver to keep the
+			   connected sender map open and read it again only if changed.
+			   ReleaseSenderName - mark the information map closed
+			 - Add the "SpoutSenderRegistry" map, maintained with the names list.
+			   GetSenderSet and FindSenderName read the registry without locking
+			   and use the names list if it has been changed by an earlier version.
+			   GetSenderSet returns the names of the last read if the generation
+			   has not changed, and compares the names list at intervals.
+			 - Add GetSenderSnapshot for a sorted list of names and information
+			   that is re-used until the registry generation or change count changes.
+			   GetSender, GetSenderIndex and GetSenderNameInfo use the snapshot.
+			 - Registry records include the sender process ID and a heartbeat time.
+			   CleanSenders uses them to check senders without opening each map
+			   and without locking the names list. GetSenderCount calls CleanSenders
+			   at an interval set by SetSweepInterval instead of every time.
+			 - Add a registry change count for receivers, incremented when a sender
+			   is created, released, changes size or format, or is made active.
+			   Add GetChangeCount.
+			 - The sender change count is incremented before and after writing.
+			   getSharedInfo reads the information without locking for senders
+			   that maintain the count. hasSharedInfo only opens the map.
+			 - Add CheckSenderNames to validate the names list and registry
+			   for stress testing with many senders and receivers.
+			   Add GetNamesLockStats for the names list mutex wait times.
+			 - The names list capacity is the size of the existing map, which can
+			   be less than the maximum senders if created by an earlier version.
+			   Senders beyond it are recorded in registry pages listed by the
+			   "SpoutSenderDirectory" map, which are added as required.
 
 
 	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -140,6 +169,8 @@
 #include "SpoutSenderNames.h"
 #include <assert.h>
 
+static bool IsSenderProcess(DWORD dwProcId);
+
 //
 // Class: spoutSenderNames
 //
@@ -161,6 +192,23 @@ spoutSenderNames::spoutSenderNames() {
 	// If the registry read fails, the default will be used
 	m_MaxSenders = (int)dwSenders;
 
+	ZeroMemory(&m_senderInfoCache, sizeof(SharedTextureInfo));
+	m_senderInfoCount = 0;
+	m_senderInfoTime = 0;
+	m_bSenderInfoValid = false;
+
+	m_registrySize = 0;
+	m_pRegistryPages = new std::vector<SpoutSharedMemory*>();
+	m_listSenders = m_MaxSenders;
+	m_pSnapshot = new std::shared_ptr<const SpoutSenderSnapshot>();
+	m_pRegistryNames = new std::set<std::string>();
+	m_registryGeneration = -1;
+	m_listCheckTime = 0;
+
+	m_sweepInterval = SPOUT_SWEEP_INTERVAL;
+	m_sweepTime = 0;
+	m_heartbeatTime = 0;
+
 }
 
 spoutSenderNames::~spoutSenderNames() {
@@ -169,6 +217,11 @@ spoutSenderNames::~spoutSenderNames() {
 		delete itr->second;
 	}
 	delete m_senders;
+	delete m_pSnapshot;
+	delete m_pRegistryNames;
+	for (auto page : *m_pRegistryPages)
+		delete page;
+	delete m_pRegistryPages;
 
 }
 
@@ -198,15 +251,7 @@ bool spoutSenderNames::RegisterSenderName(char* Sendername, bool bNewname) {
 	if (!pBuf) return false;
 
 	// Register the sender name in the list of spout senders
-	readSenderSetFromBuffer(pBuf, SenderNames, m_MaxSenders);
-
-	// Check whether the sender registration will exceed the maximum number of senders
-	// If this fails, just skip the registration
-	if ((int)SenderNames.size() == m_MaxSenders) {
-		SpoutLogWarning("spoutSenderNames::RegisterSenderName - Sender exceeds max senders (%d)\n", m_MaxSenders);
-		m_senderNames.Unlock();
-		return true;
-	}
+	readSenderSetFromBuffer(pBuf, SenderNames, m_listSenders);
 
 	// Check for name incremement
 	if (bNewname) {
@@ -224,6 +269,23 @@ bool spoutSenderNames::RegisterSenderName(char* Sendername, bool bNewname) {
 		}
 	}
 
+	// If the names list is full, record the sender in the registry pages.
+	// If this fails, just skip the registration
+	if ((int)SenderNames.size() >= m_listSenders) {
+		if (FindSenderName(Sendername)) {
+			m_senderNames.Unlock();
+			return false;
+		}
+		if (addRegistryPage(Sendername)) {
+			SetActiveSender(Sendername);
+		}
+		else {
+			SpoutLogWarning("spoutSenderNames::RegisterSenderName - Sender exceeds max senders (%d)\n", m_listSenders);
+		}
+		m_senderNames.Unlock();
+		return true;
+	}
+
 	//
 	// Add the Sender name to the set of names
 	// Does nothing if the name exists
@@ -232,13 +294,14 @@ bool spoutSenderNames::RegisterSenderName(char* Sendername, bool bNewname) {
 	if(!ret.second) {
 		// See if there are any dangling entries that aren't valid anymore
 		cleanSenderSet();
-		readSenderSetFromBuffer(pBuf, SenderNames, m_MaxSenders);
+		readSenderSetFromBuffer(pBuf, SenderNames, m_listSenders);
 		ret = SenderNames.insert(Sendername);
 	}
 
 	if(ret.second) {
 		// write the new map to shared memory
-		writeBufferFromSenderSet(SenderNames, pBuf, m_MaxSenders);
+		writeBufferFromSenderSet(SenderNames, pBuf, m_listSenders);
+		syncSenderRegistry();
 		// Set the current sender name as active.
 		// The active sender is the one selected by the user or the last one 
 		// opened by the user, so don't limit to the first sender in the list.
@@ -271,13 +334,24 @@ bool spoutSenderNames::ReleaseSenderName(const char* Sendername)
 
 	const auto foundSender = m_senders->find(Sendername);
 	if (foundSender != m_senders->end()) {
+		// Receivers can hold the map open, so mark it closed
+		char* pInfo = foundSender->second->Lock();
+		if (pInfo) {
+			SharedTextureChange* pChange = (SharedTextureChange*)(pInfo + sizeof(SharedTextureInfo));
+			if (pChange->id == SPOUT_INFO_ID) {
+				InterlockedIncrement(&pChange->count);
+				pChange->id = SPOUT_INFO_CLOSED;
+				InterlockedIncrement(&pChange->count);
+			}
+			foundSender->second->Unlock();
+		}
 		// This also deletes the sender shared memory
 		delete foundSender->second;
 		m_senders->erase(Sendername);
 	}
 
 	// Read the buffer to a set to iterate through the names
-	readSenderSetFromBuffer(pBuf, SenderNames, m_MaxSenders);
+	readSenderSetFromBuffer(pBuf, SenderNames, m_listSenders);
 
 	// Discovered that the project properties had been set to CLI
 	// Properties -> General -> Common Language Runtime Support
@@ -285,10 +359,20 @@ bool spoutSenderNames::ReleaseSenderName(const char* Sendername)
 	// It also disabled intellisense.
 
 	// If the sender exists
+	bool bReleased = false;
 	if(SenderNames.find(Sendername) != SenderNames.end() ) {
 		SenderNames.erase(Sendername);
 		// Write the sender names back to the buffer
-		writeBufferFromSenderSet(SenderNames, pBuf, m_MaxSenders);
+		writeBufferFromSenderSet(SenderNames, pBuf, m_listSenders);
+		syncSenderRegistry();
+		bReleased = true;
+	}
+	else {
+		// A sender beyond the names list
+		bReleased = removeRegistryPage(Sendername);
+	}
+
+	if (bReleased) {
 		// Is there a set left ?
 		if(SenderNames.size() > 0) {
 			// Was it the active sender ?
@@ -319,6 +403,11 @@ bool spoutSenderNames::FindSenderName(const char* Sendername)
 	if (!Sendername || !Sendername[0])
 		return false;
 
+	// Find the name in the registry without locking
+	bool bFound = false;
+	if (findSenderRegistry(Sendername, bFound))
+		return bFound;
+
 	std::set<std::string> SenderNames;
 	// Get the current names list
 	if(GetSenderSet(SenderNames)) {
@@ -346,7 +435,7 @@ void spoutSenderNames::cleanSenderSet()
 	}
 
 	std::set<std::string> SenderNames;
-	readSenderSetFromBuffer(pBuf, SenderNames, m_MaxSenders);
+	readSenderSetFromBuffer(pBuf, SenderNames, m_listSenders);
 
 	bool changed = false;
 
@@ -375,7 +464,8 @@ void spoutSenderNames::cleanSenderSet()
 
 	if (changed)
 	{
-		writeBufferFromSenderSet(SenderNames, pBuf, m_MaxSenders);
+		writeBufferFromSenderSet(SenderNames, pBuf, m_listSenders);
+		syncSenderRegistry();
 	}
 
 	m_senderNames.Unlock();
@@ -401,56 +491,40 @@ bool spoutSenderNames::GetSenderNames(std::set<std::string> *Sendernames)
 //---------------------------------------------------------
 // Function: GetSenderCount
 // Number of senders in the list
+//
+// Senders that no longer exist are removed by CleanSenders
+// if the sweep interval has elapsed since the last check.
+// If a sender is stopped without releasing, for example a Processing sketch
+// closed with STOP, the name remains in the list until then.
 int spoutSenderNames::GetSenderCount() {
 
-	std::set<std::string> SenderSet;
-	std::set<std::string>::iterator iter;
-	std::string namestring;
-	char name[SpoutMaxSenderNameLen]={};
-	SharedTextureInfo info={};
-
-	// Create the shared memory for the sender name set if it does not exist
-	if(!CreateSenderSet()) {
-		return 0;
-	}
-
-	// Doing multiple operations on the sender list, keep it locked
-	if (!m_senderNames.Lock())
-	{
-		return 0;
+	const DWORD dwTime = GetTickCount();
+	if (m_sweepTime == 0 || (dwTime - m_sweepTime) >= m_sweepInterval) {
+		CleanSenders();
+		m_sweepTime = GetTickCount();
 	}
 
-	// get the name list in shared memory into a local list
-	GetSenderNames(&SenderSet);
-
-	// Now we have a local set of names
-	// 27.12.13 - noted that if a Processing sketch is stopped by closing the window
-	// all is OK and either the "stop" or "dispose" overrides work, but if STOP is used, 
-	// or the sketch is closed, neither the exit or dispose functions are called and
-	// the sketch does not release the sender.
-	// So here we run through again and check whether the sender exists and if it does not
-	// release the sender from the local sender list
-	if(SenderSet.size() > 0) {
-		for(iter = SenderSet.begin(); iter != SenderSet.end(); iter++) {
-			namestring = *iter; // the Sender name string
-			strcpy_s(name, SpoutMaxSenderNameLen, namestring.c_str());
-			// we have the name already, so look for it's info
-			if(!getSharedInfo(&name[0], &info)) {
-				// Sender does not exist any more
-				ReleaseSenderName(&name[0]); // release from the shared memory list
-			}
-		}
-	}
+	const std::shared_ptr<const SpoutSenderSnapshot> snapshot = GetSenderSnapshot();
+	if (snapshot)
+		return (int)snapshot->names.size();
 
-	// Get the new set back
-	if(GetSenderNames(&SenderSet)) {
-		m_senderNames.Unlock();
-		return((int)SenderSet.size());
-	}
+	return 0;
+}
 
-	m_senderNames.Unlock();
+//---------------------------------------------------------
+// Function: SetSweepInterval
+// Interval between checks for orphaned senders by GetSenderCount (msec).
+// Zero checks every time.
+void spoutSenderNames::SetSweepInterval(DWORD dwInterval)
+{
+	m_sweepInterval = dwInterval;
+}
 
-	return 0;
+//---------------------------------------------------------
+// Function: GetSweepInterval
+DWORD spoutSenderNames::GetSweepInterval()
+{
+	return m_sweepInterval;
 }
 
 //---------------------------------------------------------
@@ -458,27 +532,16 @@ int spoutSenderNames::GetSenderCount() {
 // Sender item name
 bool spoutSenderNames::GetSender(int index, char* sendername, int sendernameMaxSize)
 {
-	std::set<std::string> SenderNameSet;
-	std::set<std::string>::iterator iter;
-	std::string namestring;
-	int i = 0;
+	if (!sendername)
+		return false;
 
-	if (GetSenderNames(&SenderNameSet)) {
-		if (SenderNameSet.size() < (unsigned int)index) {
-			return false;
-		}
-		i = 0;
-		for (iter = SenderNameSet.begin(); iter != SenderNameSet.end(); iter++) {
-			namestring = *iter; // the name string
-			if (i == index) {
-				strcpy_s(sendername, sendernameMaxSize, namestring.c_str());
-				break;
-			}
-			i++;
-		}
-		return true;
-	}
-	return false;
+	const std::shared_ptr<const SpoutSenderSnapshot> snapshot = GetSenderSnapshot();
+	if (!snapshot || index < 0 || index >= (int)snapshot->names.size())
+		return false;
+
+	strcpy_s(sendername, sendernameMaxSize, snapshot->names[index].c_str());
+
+	return true;
 
 }
 
@@ -487,17 +550,18 @@ bool spoutSenderNames::GetSender(int index, char* sendername, int sendernameMaxS
 // Sender index into the sender names set
 int spoutSenderNames::GetSenderIndex(const char* sendername)
 {
-	std::set<std::string> SenderNameSet;
-	std::set<std::string>::iterator iter;
-	int i = 0;
-	if (GetSenderNames(&SenderNameSet)) {
-		for (iter = SenderNameSet.begin(); iter != SenderNameSet.end(); iter++) {
-			if (*iter == sendername) {
-				return i;
-			}
-			i++;
-		}
-	}
+	if (!sendername)
+		return -1;
+
+	const std::shared_ptr<const SpoutSenderSnapshot> snapshot = GetSenderSnapshot();
+	if (!snapshot)
+		return -1;
+
+	// Names are sorted
+	const auto iter = std::lower_bound(snapshot->names.begin(), snapshot->names.end(), std::string(sendername));
+	if (iter != snapshot->names.end() && *iter == sendername)
+		return (int)(iter - snapshot->names.begin());
+
 	return -1;
 }
 
@@ -515,37 +579,219 @@ int spoutSenderNames::GetSenderIndex(const char* sendername)
 //
 bool spoutSenderNames::GetSenderNameInfo(int index, char* sendername, int sendernameMaxSize, unsigned int &width, unsigned int &height, HANDLE &dxShareHandle)
 {
-	std::set<std::string> SenderNameSet;
-	std::set<std::string>::iterator iter;
-	std::string namestring;
-	int i = 0;
 	DWORD format = 0;
 
-	if(GetSenderNames(&SenderNameSet)) {
-		if(SenderNameSet.size() < (unsigned int)index)
-			return false;
-
-		i = 0;
-		for(iter = SenderNameSet.begin(); iter != SenderNameSet.end(); iter++) {
-			namestring = *iter; // he 256 byte name string
-			if(i == index) {
-				strcpy_s(sendername, (rsize_t)sendernameMaxSize, namestring.c_str()); // return the name
-				break;
-			}
-			i++;
-		}
-		
+	if(GetSender(index, sendername, sendernameMaxSize)) {
 		// Does the retrieved sender exist or has it crashed?
 		// Find out by getting the sender info and returning it
 		if(GetSenderInfo(sendername, width, height, dxShareHandle, format))
 			return true;
-
 	}
 
 	return false;
 
 } // end GetSenderNameInfo
 
+//---------------------------------------------------------
+// Function: GetSenderSnapshot
+// Sorted sender names and information.
+//
+// The snapshot is re-used until the registry generation or change count
+// changes, so that listing senders by index does not read the names again
+// for each one. Senders increment the change count if the size, format
+// or texture changes, so the information is also current.
+// The names list is compared for changes by earlier versions at
+// SPOUT_INFO_TIMEOUT intervals, as for readSenderRegistry.
+// If the registry cannot be used, the names list is read
+// and a new snapshot is created for every call.
+std::shared_ptr<const SpoutSenderSnapshot> spoutSenderNames::GetSenderSnapshot()
+{
+	// Re-use the last snapshot if the registry has not changed
+	const SpoutRegistryHeader* header = getSenderRegistry();
+	if (header && *m_pSnapshot) {
+		const DWORD dwTime = GetTickCount();
+		const LONG generation = header->generation;
+		MemoryBarrier();
+		if ((generation & 1) == 0 && (*m_pSnapshot)->generation == generation
+			&& (*m_pSnapshot)->changes == header->changes) {
+			bool bCurrent = (dwTime - m_listCheckTime) < SPOUT_INFO_TIMEOUT;
+			if (!bCurrent && senderListHash(m_senderNames.Buffer(), m_listSenders) == header->legacyHash) {
+				m_listCheckTime = dwTime;
+				bCurrent = true;
+			}
+			if (bCurrent)
+				return *m_pSnapshot;
+		}
+	}
+
+	// The change count is read first so that a change
+	// while the information is read is found next time
+	const LONG changes = header ? header->changes : 0;
+	MemoryBarrier();
+
+	std::set<std::string> SenderNames;
+	LONG generation = -1;
+	if (!readSenderRegistry(SenderNames, &generation)) {
+		generation = -1;
+		if (!GetSenderSet(SenderNames))
+			return nullptr;
+	}
+
+	auto snapshot = std::make_shared<SpoutSenderSnapshot>();
+	snapshot->generation = generation;
+	snapshot->changes = changes;
+	snapshot->names.assign(SenderNames.begin(), SenderNames.end());
+	snapshot->info.resize(snapshot->names.size());
+	for (size_t i = 0; i < snapshot->names.size(); i++) {
+		if (!getSharedInfo(snapshot->names[i].c_str(), &snapshot->info[i]))
+			ZeroMemory(&snapshot->info[i], sizeof(SharedTextureInfo));
+	}
+
+	*m_pSnapshot = snapshot;
+
+	return snapshot;
+
+} // end GetSenderSnapshot
+
+//---------------------------------------------------------
+// Function: GetNamesLockStats
+// Names list mutex waits by this object.
+//
+// With CheckSenderNames, for stress testing with many senders
+// and receivers. Returns false if the list has not been locked.
+bool spoutSenderNames::GetNamesLockStats(SpoutLockStats& stats)
+{
+	return m_senderNames.GetLockStats(stats);
+}
+
+//---------------------------------------------------------
+// Function: CheckSenderNames
+// Check the names list and registry for corrupted entries.
+//
+//    Names must be terminated within the maximum length and not duplicated.
+//    Registry records must be found by their hash from the home index and
+//    agree with the names list if it has not been changed by an earlier version.
+//    Registry page records must not duplicate other names.
+//    Each problem is logged and false returned if any are found.
+bool spoutSenderNames::CheckSenderNames()
+{
+	bool bValid = true;
+
+	if (!CreateSenderSet())
+		return false;
+
+	char* pBuf = m_senderNames.Lock();
+	if (!pBuf)
+		return false;
+
+	// Names list
+	std::set<std::string> SenderNames;
+	const char* buf = pBuf;
+	for (int i = 0; i < m_listSenders; i++) {
+		if (!buf[0])
+			break;
+		const size_t len = strnlen(buf, SpoutMaxSenderNameLen);
+		if (len == SpoutMaxSenderNameLen) {
+			SpoutLogWarning("spoutSenderNames::CheckSenderNames - name %d not terminated", i);
+			bValid = false;
+		}
+		else if (!SenderNames.insert(std::string(buf, len)).second) {
+			SpoutLogWarning("spoutSenderNames::CheckSenderNames - name %d duplicated (%s)", i, buf);
+			bValid = false;
+		}
+		buf += SpoutMaxSenderNameLen;
+	}
+
+	// Registry
+	const SpoutRegistryHeader* header = getSenderRegistry();
+	if (header) {
+		char* pReg = m_senderRegistry.Lock();
+		if (pReg) {
+			const SpoutRegistryRecord* records = (const SpoutRegistryRecord*)(pReg + sizeof(SpoutRegistryHeader));
+			const uint32_t capacity = header->capacity;
+			if (header->generation & 1) {
+				SpoutLogWarning("spoutSenderNames::CheckSenderNames - registry write not completed");
+				bValid = false;
+			}
+			std::set<std::string> RegistryNames;
+			uint32_t count = 0;
+			for (uint32_t r = 0; r < capacity; r++) {
+				if (records[r].state == SPOUT_RECORD_EMPTY)
+					continue;
+				if (records[r].state != SPOUT_RECORD_USED) {
+					SpoutLogWarning("spoutSenderNames::CheckSenderNames - record %u invalid state %u", r, records[r].state);
+					bValid = false;
+					continue;
+				}
+				count++;
+				const size_t len = strnlen(records[r].name, SpoutMaxSenderNameLen);
+				if (len == 0 || len == SpoutMaxSenderNameLen) {
+					SpoutLogWarning("spoutSenderNames::CheckSenderNames - record %u name not terminated", r);
+					bValid = false;
+					continue;
+				}
+				const std::string name(records[r].name, len);
+				if (!RegistryNames.insert(name).second) {
+					SpoutLogWarning("spoutSenderNames::CheckSenderNames - record %u duplicated (%s)", r, name.c_str());
+					bValid = false;
+				}
+				const uint32_t hash = senderNameHash(name.c_str());
+				if (records[r].hash != hash) {
+					SpoutLogWarning("spoutSenderNames::CheckSenderNames - record %u hash mismatch (%s)", r, name.c_str());
+					bValid = false;
+					continue;
+				}
+				// An empty record between the home index and the record
+				// would stop a reader from finding it
+				for (uint32_t p = hash & (capacity - 1); p != r; p = (p + 1) & (capacity - 1)) {
+					if (records[p].state == SPOUT_RECORD_EMPTY) {
+						SpoutLogWarning("spoutSenderNames::CheckSenderNames - record %u not reachable (%s)", r, name.c_str());
+						bValid = false;
+						break;
+					}
+				}
+			}
+			if (count != header->count) {
+				SpoutLogWarning("spoutSenderNames::CheckSenderNames - registry count %u, records %u", header->count, count);
+				bValid = false;
+			}
+			if (header->legacyHash == senderListHash(pBuf, m_listSenders) && RegistryNames != SenderNames) {
+				SpoutLogWarning("spoutSenderNames::CheckSenderNames - registry differs from the names list");
+				bValid = false;
+			}
+			// Registry pages
+			const int pages = openRegistryPages();
+			for (int p = 0; p < pages; p++) {
+				const SpoutRegistryRecord* page = getRegistryPage(p);
+				for (int r = 0; r < SPOUT_PAGE_RECORDS; r++) {
+					if (page[r].state == SPOUT_RECORD_EMPTY)
+						continue;
+					const size_t len = strnlen(page[r].name, SpoutMaxSenderNameLen);
+					if (page[r].state != SPOUT_RECORD_USED || len == 0 || len == SpoutMaxSenderNameLen) {
+						SpoutLogWarning("spoutSenderNames::CheckSenderNames - page %d record %d invalid", p, r);
+						bValid = false;
+						continue;
+					}
+					const std::string name(page[r].name, len);
+					if (SenderNames.find(name) != SenderNames.end() || !RegistryNames.insert(name).second) {
+						SpoutLogWarning("spoutSenderNames::CheckSenderNames - page %d record %d duplicated (%s)", p, r, name.c_str());
+						bValid = false;
+					}
+					if (page[r].hash != senderNameHash(name.c_str())) {
+						SpoutLogWarning("spoutSenderNames::CheckSenderNames - page %d record %d hash mismatch (%s)", p, r, name.c_str());
+						bValid = false;
+					}
+				}
+			}
+			m_senderRegistry.Unlock();
+		}
+	}
+
+	m_senderNames.Unlock();
+
+	return bValid;
+}
+
 //---------------------------------------------------------
 // Function: SetMaxSenders
 // Set the maximum number of senders contained in the sender map
@@ -609,12 +855,6 @@ bool spoutSenderNames::SetSenderInfo(const char* sendername, unsigned int width,
 	if (!senderInfoMap)
 		return false;
 
-	char *pBuf = senderInfoMap->Lock();
-	if (!pBuf)
-	{
-		return false;
-	}
-		
 	info.width       = (uint32_t)width;
 	info.height      = (uint32_t)height;
 #ifdef _M_X64
@@ -655,10 +895,40 @@ bool spoutSenderNames::SetSenderInfo(const char* sendername, unsigned int width,
 	// Description is defined as wide chars, but the path is stored as byte chars
 	memcpy(&info.description[0], &exepath[0], 256); // wchar 128
 
+	char *pBuf = senderInfoMap->Lock();
+	if (!pBuf)
+	{
+		return false;
+	}
+
+	// Change count odd while writing
+	SharedTextureChange* pChange = (SharedTextureChange*)(pBuf + sizeof(SharedTextureInfo));
+	InterlockedIncrement(&pChange->count);
+
+	// Size, format or texture changed
+	const SharedTextureInfo* pInfo = (const SharedTextureInfo*)pBuf;
+	const bool bChanged = (pInfo->width != info.width
+		|| pInfo->height != info.height
+		|| pInfo->format != info.format
+		|| pInfo->shareHandle != info.shareHandle);
+
 	// Set data to the memory map
 	__movsd((unsigned long *)pBuf, (unsigned long const *)&info, sizeof(SharedTextureInfo) / 4); // 280 bytes
 
+	// Process ID following the texture information
+	pChange->id = SPOUT_INFO_ID;
+	pChange->processId = (uint32_t)dwProcId;
+
+	// Change count even when complete
+	InterlockedIncrement(&pChange->count);
+
 	senderInfoMap->Unlock();
+
+	// Process ID and heartbeat for checking the sender list
+	setRegistryHeartbeat(sendername);
+
+	if (bChanged)
+		signalRegistryChange();
 	
 	return true;
 
@@ -868,9 +1138,10 @@ bool spoutSenderNames::UpdateSender(const char *sendername, unsigned int width,
 {
 	if (m_senders->size() == 0 || (m_senders->find(sendername) == m_senders->end())) { // New sender
 
-		// Create or open a shared memory map for this sender - allocate enough for the texture info
+		// Create or open a shared memory map for this sender - allocate enough
+		// for the texture info and the change count that follows it
 		SpoutSharedMemory *senderInfoMem = new SpoutSharedMemory();
-		const SpoutCreateResult result = senderInfoMem->Create(sendername, sizeof(SharedTextureInfo));
+		const SpoutCreateResult result = senderInfoMem->Create(sendername, sizeof(SharedTextureInfo) + sizeof(SharedTextureChange));
 		if (result == SPOUT_CREATE_FAILED) {
 			delete senderInfoMem;
 			m_senderNames.Unlock();
@@ -1013,37 +1284,130 @@ bool spoutSenderNames::FindSender(const char* sendername)
 //---------------------------------------------------------
 // Function: CleanSenders
 // Release any orphaned senders if the name exists
-// in the sender list but the shared memory info does not
+// in the sender list but the sender does not.
+//
+// The registry records are read without locking. A sender is alive if
+// it has a recent heartbeat or its process is running. The information
+// map is opened only for earlier senders without a process ID.
+// The names list is locked only to release a sender.
 void spoutSenderNames::CleanSenders()
 {
-	char name[512]={};
-	std::set<std::string> Senders;
-	std::set<std::string>::iterator iter;
-	std::string namestring;
-	SharedTextureInfo info={};
+	struct SenderState {
+		std::string name;
+		uint32_t processId;
+		LONG heartbeat;
+	};
+	std::vector<SenderState> senders;
+
+	const SpoutRegistryHeader* header = getSenderRegistry();
+	bool bRead = false;
+	if (header) {
+		const SpoutRegistryRecord* records = (const SpoutRegistryRecord*)(header + 1);
+		const uint32_t capacity = header->capacity;
+		for (int i = 0; i < SPOUT_REGISTRY_RETRIES && !bRead; i++) {
+			const LONG generation = header->generation;
+			if (generation & 1) {
+				YieldProcessor();
+				continue;
+			}
+			MemoryBarrier();
+			senders.clear();
+			for (uint32_t r = 0; r < capacity; r++) {
+				if (records[r].state == SPOUT_RECORD_USED) {
+					SenderState state;
+					state.name.assign(records[r].name, strnlen(records[r].name, SpoutMaxSenderNameLen));
+					state.processId = records[r].processId;
+					state.heartbeat = records[r].heartbeat;
+					senders.push_back(state);
+				}
+			}
+			const int pages = openRegistryPages();
+			for (int p = 0; p < pages; p++) {
+				const SpoutRegistryRecord* page = getRegistryPage(p);
+				for (int r = 0; r < SPOUT_PAGE_RECORDS; r++) {
+					if (page[r].state == SPOUT_RECORD_USED) {
+						SenderState state;
+						state.name.assign(page[r].name, strnlen(page[r].name, SpoutMaxSenderNameLen));
+						state.processId = page[r].processId;
+						state.heartbeat = page[r].heartbeat;
+						senders.push_back(state);
+					}
+				}
+			}
+			const uint32_t listHash = header->legacyHash;
+			MemoryBarrier();
+			if (header->generation != generation)
+				continue;
+			bRead = (senderListHash(m_senderNames.Buffer(), m_listSenders) == listHash);
+			break;
+		}
+	}
+
+	if (!bRead) {
+		// Get the sender name list in shared memory
+		// The registry is re-built if it was not current
+		std::set<std::string> Senders;
+		GetSenderNames(&Senders);
+		senders.clear();
+		for (const auto& name : Senders) {
+			SenderState state;
+			state.name = name;
+			state.processId = 0;
+			state.heartbeat = 0;
+			senders.push_back(state);
+		}
+	}
 
-	// get the sender name list in shared memory into a local list
-	GetSenderNames(&Senders);
-
-	// Now we have a local set of names "Senders"
-	// Run through the set and check whether the sender exists
-	// If it does not exist, release from the sender list
-	if (Senders.size() > 0) {
-		for (iter = Senders.begin(); iter != Senders.end(); iter++) {
-			namestring = *iter; // the Sender name string
-			strcpy_s(name, namestring.c_str());
-			// we have the name already, so look for it's info
-			if (!getSharedInfo(&name[0], &info)) {
-				SpoutLogWarning("spoutSenderNames::CleanSenders - removing [%s]", &name[0]);
-				// Sender does not exist any more so remove from the names list
-				ReleaseSenderName(&name[0]);
+	const DWORD dwTime = GetTickCount();
+	SharedTextureInfo info={};
+	for (const auto& state : senders) {
+		// Senders created by this class
+		if (m_senders->find(state.name) != m_senders->end())
+			continue;
+		bool bAlive = false;
+		if (state.processId != 0) {
+			bAlive = (dwTime - (DWORD)state.heartbeat) < SPOUT_HEARTBEAT_TIMEOUT;
+			if (!bAlive && IsSenderProcess((DWORD)state.processId)) {
+				// The heartbeat is stale but the process is running.
+				// The process can have released the sender or still be
+				// sending without frames, so look for the information map
+				// and check that it has not been marked closed.
+				SpoutSharedMemory mem;
+				if (mem.Open(state.name.c_str()) && mem.Buffer()) {
+					const SharedTextureChange* pChange = (const SharedTextureChange*)(mem.Buffer() + sizeof(SharedTextureInfo));
+					bAlive = (pChange->id != SPOUT_INFO_CLOSED);
+				}
 			}
 		}
+		else {
+			// Earlier sender version - look for it's info
+			bAlive = getSharedInfo(state.name.c_str(), &info);
+		}
+		if (!bAlive) {
+			SpoutLogWarning("spoutSenderNames::CleanSenders - removing [%s]", state.name.c_str());
+			// Sender does not exist any more so remove from the names list
+			ReleaseSenderName(state.name.c_str());
+		}
 	}
 
-	// Now we have cleaned up the list in shared memory
-	Senders.clear();
+}
 
+//---------------------------------------------------------
+// Function: UpdateHeartbeat
+// Update the registry heartbeat of the senders created by this class.
+// Called for every frame sent and written at SPOUT_HEARTBEAT_INTERVAL.
+void spoutSenderNames::UpdateHeartbeat()
+{
+	if (m_senders->empty())
+		return;
+
+	const DWORD dwTime = GetTickCount();
+	if ((dwTime - m_heartbeatTime) < SPOUT_HEARTBEAT_INTERVAL)
+		return;
+	m_heartbeatTime = dwTime;
+
+	for (const auto& sender : *m_senders)
+		setRegistryHeartbeat(sender.first.c_str());
 }
 // ================================================
 
@@ -1134,6 +1498,12 @@ bool spoutSenderNames::CreateSenderSet()
 		return false;
 	}
 
+	// Names that the existing map can hold.
+	// Senders beyond this are recorded in the registry pages.
+	m_listSenders = m_MaxSenders;
+	if (m_senderNames.Size() / SpoutMaxSenderNameLen < m_listSenders)
+		m_listSenders = m_senderNames.Size() / SpoutMaxSenderNameLen;
+
 	return true;
 
 } // end CreateSenderSet
@@ -1147,11 +1517,20 @@ bool spoutSenderNames::GetSenderSet(std::set<std::string>& SenderNames) {
 		return false;
 	}
 
+	// Read the registry without locking if it is current
+	if (readSenderRegistry(SenderNames)) {
+		return true;
+	}
+
 	pBuf = m_senderNames.Lock();
 	if (!pBuf) {
 		return false;
 	}
 
+	// The registry is not initialized, or the names list
+	// has been changed by an earlier version
+	syncSenderRegistry();
+
 	// The data has been stored with 256 bytes reserved for each Sender name
 	// and nothing will have changed with the map yet
 	if(!*pBuf) { // no senders yet
@@ -1162,7 +1541,7 @@ bool spoutSenderNames::GetSenderSet(std::set<std::string>& SenderNames) {
 	// Read back from the mapped memory buffer and rebuild the set that was passed in
 	// The set will then contain the senders currently in the memory map
 	// and allow for any that have been added or deleted
-	readSenderSetFromBuffer(pBuf, SenderNames, m_MaxSenders);
+	readSenderSetFromBuffer(pBuf, SenderNames, m_listSenders);
 
 	m_senderNames.Unlock();
 
@@ -1170,6 +1549,543 @@ bool spoutSenderNames::GetSenderSet(std::set<std::string>& SenderNames) {
 
 } // end GetSenderSet
 
+//
+// Sender registry
+//
+
+// Create or open the registry shared memory
+bool spoutSenderNames::CreateSenderRegistry()
+{
+	if (m_registrySize > 0)
+		return true;
+
+	// Power of 2 at least twice the maximum number of senders
+	uint32_t capacity = 16;
+	while (capacity < (uint32_t)m_MaxSenders*2)
+		capacity *= 2;
+
+	const int size = (int)(sizeof(SpoutRegistryHeader) + capacity*sizeof(SpoutRegistryRecord));
+	const SpoutCreateResult result = m_senderRegistry.Create("SpoutSenderRegistry", size);
+	if (result == SPOUT_CREATE_FAILED) {
+		SpoutLogError("spoutSenderNames::CreateSenderRegistry() : SPOUT_CREATE_FAILED");
+		return false;
+	}
+
+	// An existing map has the size it was created with
+	MEMORY_BASIC_INFORMATION mbi={};
+	if (VirtualQuery(m_senderRegistry.Buffer(), &mbi, sizeof(mbi)) == 0) {
+		m_senderRegistry.Close();
+		return false;
+	}
+	m_registrySize = mbi.RegionSize;
+
+	return true;
+
+} // end CreateSenderRegistry
+
+// Return the registry header if the registry is initialized
+const SpoutRegistryHeader* spoutSenderNames::getSenderRegistry()
+{
+	if (!CreateSenderSet() || !CreateSenderRegistry())
+		return nullptr;
+
+	const SpoutRegistryHeader* header = (const SpoutRegistryHeader*)m_senderRegistry.Buffer();
+	if (!header || header->id != SPOUT_REGISTRY_ID)
+		return nullptr;
+
+	// Capacity must be a power of 2 within the map
+	const uint32_t capacity = header->capacity;
+	if (capacity == 0 || (capacity & (capacity - 1)) != 0
+		|| sizeof(SpoutRegistryHeader) + (size_t)capacity*sizeof(SpoutRegistryRecord) > m_registrySize)
+		return nullptr;
+
+	return header;
+
+} // end getSenderRegistry
+
+// Re-build the registry from the names list if they are different.
+// The sender names map must be locked by the caller.
+void spoutSenderNames::syncSenderRegistry()
+{
+	if (!CreateSenderRegistry())
+		return;
+
+	const char* pNames = m_senderNames.Buffer();
+	if (!pNames)
+		return;
+
+	char* pBuf = m_senderRegistry.Lock();
+	if (!pBuf)
+		return;
+
+	SpoutRegistryHeader* header = (SpoutRegistryHeader*)pBuf;
+	SpoutRegistryRecord* records = (SpoutRegistryRecord*)(pBuf + sizeof(SpoutRegistryHeader));
+
+	const uint32_t listHash = senderListHash(pNames, m_listSenders);
+	if (header->id == SPOUT_REGISTRY_ID
+		&& (header->generation & 1) == 0
+		&& header->legacyHash == listHash) {
+		m_senderRegistry.Unlock();
+		return;
+	}
+
+	// Odd generation while writing.
+	// It could already be odd if a writer did not complete.
+	if ((header->generation & 1) == 0)
+		InterlockedIncrement(&header->generation);
+
+	if (header->id != SPOUT_REGISTRY_ID) {
+		uint32_t capacity = 16;
+		while (sizeof(SpoutRegistryHeader) + (size_t)capacity*2*sizeof(SpoutRegistryRecord) <= m_registrySize)
+			capacity *= 2;
+		header->capacity = capacity;
+	}
+	const uint32_t capacity = header->capacity;
+
+	// Retain the process ID and heartbeat of existing senders
+	std::unordered_map<std::string, std::pair<uint32_t, LONG>> states;
+	if (header->id == SPOUT_REGISTRY_ID) {
+		for (uint32_t r = 0; r < capacity; r++) {
+			if (records[r].state == SPOUT_RECORD_USED && records[r].processId != 0) {
+				states[std::string(records[r].name, strnlen(records[r].name, SpoutMaxSenderNameLen))]
+					= std::make_pair(records[r].processId, (LONG)records[r].heartbeat);
+			}
+		}
+	}
+	ZeroMemory(records, (size_t)capacity*sizeof(SpoutRegistryRecord));
+
+	// Insert the names with linear probing from the hash index
+	uint32_t count = 0;
+	char name[SpoutMaxSenderNameLen]={};
+	const char* buf = pNames;
+	for (int i = 0; i < m_listSenders && count < capacity; i++) {
+		strncpy_s(name, buf, SpoutMaxSenderNameLen);
+		if (!name[0])
+			break;
+		const uint32_t hash = senderNameHash(name);
+		uint32_t r = hash & (capacity - 1);
+		while (records[r].state != SPOUT_RECORD_EMPTY)
+			r = (r + 1) & (capacity - 1);
+		records[r].state = SPOUT_RECORD_USED;
+		records[r].hash = hash;
+		strcpy_s(records[r].name, SpoutMaxSenderNameLen, name);
+		const auto state = states.find(name);
+		if (state != states.end()) {
+			records[r].processId = state->second.first;
+			records[r].heartbeat = state->second.second;
+		}
+		count++;
+		buf += SpoutMaxSenderNameLen;
+	}
+	header->count = count;
+	header->legacyHash = listHash;
+	header->id = SPOUT_REGISTRY_ID;
+	InterlockedIncrement(&header->changes);
+
+	// Even generation when complete
+	InterlockedIncrement(&header->generation);
+
+	m_senderRegistry.Unlock();
+
+} // end syncSenderRegistry
+
+// Read the sender names from the registry without locking.
+// Returns false if the registry is not initialized, is being written,
+// or the names list has been changed by an earlier version.
+bool spoutSenderNames::readSenderRegistry(std::set<std::string>& SenderNames, LONG* pGeneration)
+{
+	const SpoutRegistryHeader* header = getSenderRegistry();
+	if (!header)
+		return false;
+
+	// Return the names of the last read if the generation has not changed.
+	// The names list is compared for changes by earlier versions
+	// at SPOUT_INFO_TIMEOUT intervals instead of for every read.
+	const DWORD dwTime = GetTickCount();
+	const LONG current = header->generation;
+	MemoryBarrier();
+	if ((current & 1) == 0 && current == m_registryGeneration) {
+		bool bCurrent = (dwTime - m_listCheckTime) < SPOUT_INFO_TIMEOUT;
+		if (!bCurrent && senderListHash(m_senderNames.Buffer(), m_listSenders) == header->legacyHash) {
+			m_listCheckTime = dwTime;
+			bCurrent = true;
+		}
+		if (bCurrent && header->generation == current) {
+			SenderNames = *m_pRegistryNames;
+			if (pGeneration)
+				*pGeneration = current;
+			return true;
+		}
+	}
+	m_registryGeneration = -1;
+
+	const SpoutRegistryRecord* records = (const SpoutRegistryRecord*)(header + 1);
+	const uint32_t capacity = header->capacity;
+
+	for (int i = 0; i < SPOUT_REGISTRY_RETRIES; i++) {
+		const LONG generation = header->generation;
+		if (generation & 1) {
+			YieldProcessor();
+			continue;
+		}
+		MemoryBarrier();
+		SenderNames.clear();
+		for (uint32_t r = 0; r < capacity; r++) {
+			if (records[r].state == SPOUT_RECORD_USED)
+				SenderNames.insert(std::string(records[r].name, strnlen(records[r].name, SpoutMaxSenderNameLen)));
+		}
+		// Senders beyond the names list
+		const int pages = openRegistryPages();
+		for (int p = 0; p < pages; p++) {
+			const SpoutRegistryRecord* page = getRegistryPage(p);
+			for (int r = 0; r < SPOUT_PAGE_RECORDS; r++) {
+				if (page[r].state == SPOUT_RECORD_USED)
+					SenderNames.insert(std::string(page[r].name, strnlen(page[r].name, SpoutMaxSenderNameLen)));
+			}
+		}
+		const uint32_t listHash = header->legacyHash;
+		MemoryBarrier();
+		if (header->generation != generation)
+			continue;
+		if (pGeneration)
+			*pGeneration = generation;
+		if (senderListHash(m_senderNames.Buffer(), m_listSenders) != listHash)
+			return false;
+		// Keep the names for reads until the generation changes
+		*m_pRegistryNames = SenderNames;
+		m_registryGeneration = generation;
+		m_listCheckTime = dwTime;
+		return true;
+	}
+
+	return false;
+
+} // end readSenderRegistry
+
+// Find a sender name in the registry without locking.
+// Returns false if the registry cannot be used.
+bool spoutSenderNames::findSenderRegistry(const char* SenderName, bool &bFound)
+{
+	const SpoutRegistryHeader* header = getSenderRegistry();
+	if (!header)
+		return false;
+
+	const SpoutRegistryRecord* records = (const SpoutRegistryRecord*)(header + 1);
+	const uint32_t capacity = header->capacity;
+	const uint32_t hash = senderNameHash(SenderName);
+
+	for (int i = 0; i < SPOUT_REGISTRY_RETRIES; i++) {
+		const LONG generation = header->generation;
+		if (generation & 1) {
+			YieldProcessor();
+			continue;
+		}
+		MemoryBarrier();
+		bFound = false;
+		uint32_t r = hash & (capacity - 1);
+		for (uint32_t n = 0; n < capacity && records[r].state != SPOUT_RECORD_EMPTY; n++) {
+			if (records[r].hash == hash
+				&& strncmp(records[r].name, SenderName, SpoutMaxSenderNameLen) == 0) {
+				bFound = true;
+				break;
+			}
+			r = (r + 1) & (capacity - 1);
+		}
+		// Senders beyond the names list
+		const int pages = bFound ? 0 : openRegistryPages();
+		for (int p = 0; p < pages && !bFound; p++) {
+			const SpoutRegistryRecord* page = getRegistryPage(p);
+			for (int n = 0; n < SPOUT_PAGE_RECORDS; n++) {
+				if (page[n].state == SPOUT_RECORD_USED && page[n].hash == hash
+					&& strncmp(page[n].name, SenderName, SpoutMaxSenderNameLen) == 0) {
+					bFound = true;
+					break;
+				}
+			}
+		}
+		const uint32_t listHash = header->legacyHash;
+		MemoryBarrier();
+		if (header->generation != generation)
+			continue;
+		return (senderListHash(m_senderNames.Buffer(), m_listSenders) == listHash);
+	}
+
+	return false;
+
+} // end findSenderRegistry
+
+// Find the record of a sender name in a locked registry buffer
+// or the registry pages
+SpoutRegistryRecord* spoutSenderNames::findRegistryRecord(char* pBuf, const char* SenderName)
+{
+	const SpoutRegistryHeader* header = (const SpoutRegistryHeader*)pBuf;
+	if (header->id != SPOUT_REGISTRY_ID)
+		return nullptr;
+
+	SpoutRegistryRecord* records = (SpoutRegistryRecord*)(pBuf + sizeof(SpoutRegistryHeader));
+	const uint32_t capacity = header->capacity;
+	const uint32_t hash = senderNameHash(SenderName);
+	uint32_t r = hash & (capacity - 1);
+	for (uint32_t n = 0; n < capacity && records[r].state != SPOUT_RECORD_EMPTY; n++) {
+		if (records[r].hash == hash
+			&& strncmp(records[r].name, SenderName, SpoutMaxSenderNameLen) == 0)
+			return &records[r];
+		r = (r + 1) & (capacity - 1);
+	}
+	const int pages = openRegistryPages();
+	for (int p = 0; p < pages; p++) {
+		SpoutRegistryRecord* page = getRegistryPage(p);
+		for (int n = 0; n < SPOUT_PAGE_RECORDS; n++) {
+			if (page[n].state == SPOUT_RECORD_USED && page[n].hash == hash
+				&& strncmp(page[n].name, SenderName, SpoutMaxSenderNameLen) == 0)
+				return &page[n];
+		}
+	}
+	return nullptr;
+}
+
+// Set the process ID and heartbeat time of a sender created by this class
+void spoutSenderNames::setRegistryHeartbeat(const char* SenderName)
+{
+	if (!getSenderRegistry())
+		return;
+
+	char* pBuf = m_senderRegistry.Lock();
+	if (!pBuf)
+		return;
+
+	SpoutRegistryRecord* record = findRegistryRecord(pBuf, SenderName);
+	if (record) {
+		record->processId = (uint32_t)GetCurrentProcessId();
+		InterlockedExchange(&record->heartbeat, (LONG)GetTickCount());
+	}
+
+	m_senderRegistry.Unlock();
+}
+
+// Let receivers know that a sender has changed
+void spoutSenderNames::signalRegistryChange()
+{
+	if (!getSenderRegistry())
+		return;
+
+	char* pBuf = m_senderRegistry.Lock();
+	if (!pBuf)
+		return;
+
+	InterlockedIncrement(&((SpoutRegistryHeader*)pBuf)->changes);
+
+	m_senderRegistry.Unlock();
+}
+
+//---------------------------------------------------------
+// Function: GetChangeCount
+// Count of sender changes.
+//
+// Incremented when a sender is created, released, changes size
+// or format, or is made active. A receiver that is not connected
+// can compare the count with the last value instead of reading the
+// sender list for every frame. Earlier sender versions do not
+// increment the count, so the list should still be checked at
+// intervals. Returns zero if the registry is not available.
+LONG spoutSenderNames::GetChangeCount()
+{
+	const SpoutRegistryHeader* header = getSenderRegistry();
+	if (!header)
+		return 0;
+	return header->changes;
+}
+
+// FNV-1a hash of a sender name
+uint32_t spoutSenderNames::senderNameHash(const char* SenderName)
+{
+	uint32_t hash = 2166136261u;
+	for (int i = 0; i < SpoutMaxSenderNameLen && SenderName[i]; i++) {
+		hash ^= (uint8_t)SenderName[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+// FNV-1a hash of the names in a names list buffer, including terminators
+uint32_t spoutSenderNames::senderListHash(const char* buffer, int maxSenders)
+{
+	uint32_t hash = 2166136261u;
+	if (!buffer)
+		return hash;
+
+	for (int i = 0; i < maxSenders; i++) {
+		const char* name = buffer + (size_t)i*SpoutMaxSenderNameLen;
+		if (!name[0])
+			break;
+		for (int j = 0; j < SpoutMaxSenderNameLen; j++) {
+			hash ^= (uint8_t)name[j];
+			hash *= 16777619u;
+			if (!name[j])
+				break;
+		}
+	}
+	return hash;
+}
+
+//
+// Registry pages
+//
+
+// Create or open the directory of registry pages
+SpoutRegistryDirectory* spoutSenderNames::getRegistryDirectory()
+{
+	if (!m_senderDirectory.Buffer()) {
+		const SpoutCreateResult result = m_senderDirectory.Create("SpoutSenderDirectory", (int)sizeof(SpoutRegistryDirectory));
+		if (result == SPOUT_CREATE_FAILED) {
+			SpoutLogError("spoutSenderNames::getRegistryDirectory() : SPOUT_CREATE_FAILED");
+			return nullptr;
+		}
+	}
+
+	SpoutRegistryDirectory* directory = (SpoutRegistryDirectory*)m_senderDirectory.Buffer();
+	if (directory->pages < 0 || directory->pages > SPOUT_DIRECTORY_PAGES
+		|| (directory->pages > 0 && directory->id != SPOUT_DIRECTORY_ID))
+		return nullptr;
+
+	return directory;
+}
+
+// Open registry pages added to the directory since last opened.
+// Writers create a page if it does not exist.
+// Returns the number of pages open.
+int spoutSenderNames::openRegistryPages(bool bCreate)
+{
+	const SpoutRegistryDirectory* directory = getRegistryDirectory();
+	if (!directory)
+		return 0;
+
+	const int pages = (int)directory->pages;
+	while ((int)m_pRegistryPages->size() < pages) {
+		const int index = (int)m_pRegistryPages->size();
+		char pagename[64]={};
+		sprintf_s(pagename, 64, "SpoutSenderPage_%u", directory->page[index]);
+		const int size = (int)(SPOUT_PAGE_RECORDS*sizeof(SpoutRegistryRecord));
+		SpoutSharedMemory* page = new SpoutSharedMemory();
+		bool bOpen = false;
+		if (bCreate)
+			bOpen = (page->Create(pagename, size) != SPOUT_CREATE_FAILED);
+		else
+			bOpen = page->Open(pagename);
+		if (!bOpen || page->Size() < size) {
+			delete page;
+			break;
+		}
+		m_pRegistryPages->push_back(page);
+	}
+
+	return (int)m_pRegistryPages->size();
+}
+
+// Records of an open registry page
+SpoutRegistryRecord* spoutSenderNames::getRegistryPage(int index)
+{
+	return (SpoutRegistryRecord*)(*m_pRegistryPages)[index]->Buffer();
+}
+
+// Record a sender in the registry pages, adding a page if they are full.
+// The sender names map must be locked by the caller.
+bool spoutSenderNames::addRegistryPage(const char* SenderName)
+{
+	if (!getSenderRegistry())
+		return false;
+
+	SpoutRegistryDirectory* directory = getRegistryDirectory();
+	if (!directory)
+		return false;
+
+	char* pBuf = m_senderRegistry.Lock();
+	if (!pBuf)
+		return false;
+
+	// Find an empty record
+	SpoutRegistryRecord* record = nullptr;
+	int pages = openRegistryPages(true);
+	for (int p = 0; p < pages && !record; p++) {
+		SpoutRegistryRecord* page = getRegistryPage(p);
+		for (int r = 0; r < SPOUT_PAGE_RECORDS; r++) {
+			if (page[r].state == SPOUT_RECORD_EMPTY) {
+				record = &page[r];
+				break;
+			}
+		}
+	}
+
+	// Add a page
+	if (!record) {
+		if (pages < (int)directory->pages || pages >= SPOUT_DIRECTORY_PAGES) {
+			m_senderRegistry.Unlock();
+			return false;
+		}
+		directory->page[pages] = (pages > 0) ? directory->page[pages-1] + 1 : 1;
+		directory->id = SPOUT_DIRECTORY_ID;
+		InterlockedIncrement(&directory->pages);
+		if (openRegistryPages(true) <= pages) {
+			InterlockedDecrement(&directory->pages);
+			m_senderRegistry.Unlock();
+			return false;
+		}
+		record = getRegistryPage(pages);
+		SpoutLogNotice("spoutSenderNames::addRegistryPage - added registry page %d", pages + 1);
+	}
+
+	SpoutRegistryHeader* header = (SpoutRegistryHeader*)pBuf;
+	if ((header->generation & 1) == 0)
+		InterlockedIncrement(&header->generation);
+	record->hash = senderNameHash(SenderName);
+	record->processId = 0;
+	record->heartbeat = 0;
+	strcpy_s(record->name, SpoutMaxSenderNameLen, SenderName);
+	record->state = SPOUT_RECORD_USED;
+	InterlockedIncrement(&header->changes);
+	InterlockedIncrement(&header->generation);
+
+	m_senderRegistry.Unlock();
+
+	return true;
+}
+
+// Remove a sender from the registry pages.
+// The sender names map must be locked by the caller.
+bool spoutSenderNames::removeRegistryPage(const char* SenderName)
+{
+	if (!getSenderRegistry())
+		return false;
+
+	char* pBuf = m_senderRegistry.Lock();
+	if (!pBuf)
+		return false;
+
+	bool bFound = false;
+	const uint32_t hash = senderNameHash(SenderName);
+	const int pages = openRegistryPages(true);
+	for (int p = 0; p < pages && !bFound; p++) {
+		SpoutRegistryRecord* page = getRegistryPage(p);
+		for (int r = 0; r < SPOUT_PAGE_RECORDS; r++) {
+			if (page[r].state == SPOUT_RECORD_USED && page[r].hash == hash
+				&& strncmp(page[r].name, SenderName, SpoutMaxSenderNameLen) == 0) {
+				SpoutRegistryHeader* header = (SpoutRegistryHeader*)pBuf;
+				if ((header->generation & 1) == 0)
+					InterlockedIncrement(&header->generation);
+				ZeroMemory(&page[r], sizeof(SpoutRegistryRecord));
+				InterlockedIncrement(&header->changes);
+				InterlockedIncrement(&header->generation);
+				bFound = true;
+				break;
+			}
+		}
+	}
+
+	m_senderRegistry.Unlock();
+
+	return bFound;
+}
+
 // Create a shared memory map to set the active Sender name to shared memory
 // This is a separate small shared memory with a fixed sharing name
 // that clients can use to retrieve the current active Sender
@@ -1194,6 +2110,7 @@ bool spoutSenderNames::setActiveSenderName(const char* SenderName)
 		// Fill it with the Sender name string
 		memcpy((void*)pBuf, (void*)SenderName, len + 1); // write the Sender name string to the shared memory
 		m_activeSender.Unlock();
+		signalRegistryChange();
 		return true;
 	}
 	SpoutLogWarning("spoutSenderNames::setActiveSenderName - could not create memory");
@@ -1234,6 +2151,13 @@ bool spoutSenderNames::getSharedInfo(const char* sharedMemoryName, SharedTexture
 	SpoutSharedMemory mem;
 	// Open is possibly faster than Create because the function is called all the time
 	if(mem.Open(sharedMemoryName)) {
+		// Read without locking if the sender maintains the change count
+		const SharedTextureChange* pChange = (const SharedTextureChange*)(mem.Buffer() + sizeof(SharedTextureInfo));
+		if (pChange->id == SPOUT_INFO_ID
+			&& mem.ReadSequenced(info, 0, sizeof(SharedTextureInfo), SPOUT_INFO_SEQUENCE)) {
+			return true;
+		}
+		// Earlier sender versions or a sequenced read failed
 		const char *pBuf = mem.Lock();
 		if(pBuf) {
 			__movsd((unsigned long *)info, (unsigned long const *)pBuf, sizeof(SharedTextureInfo) / 4); // 280 bytes
@@ -1261,8 +2185,17 @@ bool spoutSenderNames::setSharedInfo(const char* sharedMemoryName, const SharedT
 		return false;
 	}
 
+	// Let receivers know that the information is changing
+	SharedTextureChange* pChange = (SharedTextureChange*)(pBuf + sizeof(SharedTextureInfo));
+	const bool bSequenced = (pChange->id == SPOUT_INFO_ID);
+	if (bSequenced)
+		InterlockedIncrement(&pChange->count);
+
 	__movsd((unsigned long *)pBuf, (unsigned long const *)info, sizeof(SharedTextureInfo) / 4); // 280 bytes
 
+	if (bSequenced)
+		InterlockedIncrement(&pChange->count);
+
 	mem.Unlock();
 	
 	return true;
@@ -1273,13 +2206,121 @@ bool spoutSenderNames::setSharedInfo(const char* sharedMemoryName, const SharedT
 // Test for shared info memory map existence
 bool spoutSenderNames::hasSharedInfo(const char* sharedMemoryName)
 {
+	// The map exists if it can be opened
 	SpoutSharedMemory mem;
-	if (mem.Open(sharedMemoryName)) {
-		if (mem.Lock()) {
-			mem.Unlock();
+	return mem.Open(sharedMemoryName);
+
+} // end hasSharedInfo
+
+// Test whether a sender process is still running
+static bool IsSenderProcess(DWORD dwProcId)
+{
+	// Unknown process
+	if (dwProcId == 0)
+		return true;
+
+	HANDLE hProc = OpenProcess(SYNCHRONIZE, FALSE, dwProcId);
+	if (!hProc) {
+		// Access can be denied for another user or elevated process
+		// but the process ID is invalid if it has exited
+		return (GetLastError() != ERROR_INVALID_PARAMETER);
+	}
+	const bool bRunning = (WaitForSingleObject(hProc, 0) == WAIT_TIMEOUT);
+	CloseHandle(hProc);
+	return bRunning;
+}
+
+//---------------------------------------------------------
+// Function: CheckSenderInfo
+// Read the information of the connected sender.
+//
+// Replaces getSharedInfo for a receiver that reads the same sender
+// every frame. The sender map is kept open and the change count that
+// follows the texture information is tested without a lock.
+// The information is read again only if the count changes, or at
+// SPOUT_INFO_TIMEOUT intervals to confirm that the sender still exists.
+// Earlier sender versions do not maintain a change count and the
+// information is read every time as for getSharedInfo.
+//
+// Returns false if the sender does not exist.
+bool spoutSenderNames::CheckSenderInfo(const char* sendername, SharedTextureInfo* info)
+{
+	if (!sendername || !sendername[0] || !info)
+		return false;
+
+	// Close the map of a different sender
+	if (m_senderInfo.Name() && strcmp(m_senderInfo.Name(), sendername) != 0)
+		CloseSenderInfo();
+
+	const DWORD dwTime = GetTickCount();
+
+	// Return the saved information if the change count is the same
+	if (m_bSenderInfoValid && m_senderInfo.Buffer()) {
+		const SharedTextureChange* pChange = (const SharedTextureChange*)(m_senderInfo.Buffer() + sizeof(SharedTextureInfo));
+		if (pChange->id == SPOUT_INFO_ID
+			&& pChange->count == m_senderInfoCount
+			&& (dwTime - m_senderInfoTime) < SPOUT_INFO_TIMEOUT) {
+			*info = m_senderInfoCache;
 			return true;
 		}
 	}
-	return false;
 
-} // end hasSharedInfo
+	// Full validation.
+	// Close and open the map again to confirm that the sender still exists.
+	CloseSenderInfo();
+	if (!m_senderInfo.Open(sendername))
+		return false;
+
+	// Information and change count together
+	struct {
+		SharedTextureInfo info;
+		SharedTextureChange change;
+	} data={};
+	const SharedTextureChange* pChange = (const SharedTextureChange*)(m_senderInfo.Buffer() + sizeof(SharedTextureInfo));
+	if (pChange->id != SPOUT_INFO_ID
+		|| !m_senderInfo.ReadSequenced(&data, 0, (int)sizeof(data), SPOUT_INFO_SEQUENCE)) {
+		const char* pBuf = m_senderInfo.Lock();
+		if (!pBuf) {
+			m_senderInfo.Close();
+			return false;
+		}
+		memcpy(&data, pBuf, sizeof(data));
+		m_senderInfo.Unlock();
+	}
+	*info = data.info;
+	const SharedTextureChange change = data.change;
+
+	if (change.id == SPOUT_INFO_ID) {
+		// The map remains while any receiver holds it open,
+		// so check that the sender is still running
+		if (!IsSenderProcess((DWORD)change.processId)) {
+			m_senderInfo.Close();
+			return false;
+		}
+		m_senderInfoCache = *info;
+		m_senderInfoCount = change.count;
+		m_senderInfoTime = dwTime;
+		m_bSenderInfoValid = true;
+	}
+	else if (change.id == SPOUT_INFO_CLOSED) {
+		// The sender has released but another receiver holds the map
+		m_senderInfo.Close();
+		return false;
+	}
+	else {
+		// No change count. Close the map to detect when the sender closes.
+		m_senderInfo.Close();
+	}
+
+	return true;
+
+} // end CheckSenderInfo
+
+//---------------------------------------------------------
+// Function: CloseSenderInfo
+// Close the connected sender information map
+void spoutSenderNames::CloseSenderInfo()
+{
+	m_senderInfo.Close();
+	m_bSenderInfoValid = false;
+}
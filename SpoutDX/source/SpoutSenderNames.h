@@ -46,6 +46,8 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <memory> // for shared_ptr
+#include <algorithm> // for lower_bound
 #include <intrin.h> // for __movsd
 #include <stdint.h> // for _uint32
 #include <assert.h>
@@ -79,6 +81,101 @@ struct SharedTextureInfo {		// 280 bytes total
 	uint32_t partnerId;			// 4 bytes : ID
 };
 
+//
+// Change detection following the texture information in a sender memory map.
+// The map is created larger than SharedTextureInfo and the additional
+// bytes are ignored by earlier versions. A receiver can test the count
+// without locking the map and read the information again only if it changes.
+//
+#define SPOUT_INFO_ID     0x31435053 // "SPC1" - change count is maintained
+#define SPOUT_INFO_CLOSED 0x58435053 // "SPCX" - the sender has closed
+
+// Re-validate the connected sender at this interval even if unchanged (msec)
+#define SPOUT_INFO_TIMEOUT 1000
+
+struct SharedTextureChange {	// 16 bytes total
+	uint32_t id;				// 4 bytes : SPOUT_INFO_ID or SPOUT_INFO_CLOSED
+	uint32_t processId;			// 4 bytes : sender process ID
+	volatile LONG count;		// 4 bytes : incremented before and after every information update
+	uint32_t reserved;			// 4 bytes : unused
+};
+
+// Offset of the change count in the sender map.
+// The count is odd while the information is written, so that
+// receivers can read it without locking (SpoutSharedMemory::ReadSequenced).
+#define SPOUT_INFO_SEQUENCE ((int)(sizeof(SharedTextureInfo) + offsetof(SharedTextureChange, count)))
+
+//
+// Sender registry.
+// The "SpoutSenderRegistry" map is maintained together with the "SpoutSenderNames"
+// list of 256 byte names, which is retained for earlier versions. Writers hold the
+// sender names mutex. Readers do not lock. The generation is odd while the registry
+// is being written and readers retry if it is odd or changes during the read.
+// The hash of the names list is recorded so that changes made by earlier versions
+// are detected and the registry re-built.
+//
+#define SPOUT_REGISTRY_ID      0x31525053 // "SPR1" - registry initialized
+#define SPOUT_REGISTRY_RETRIES 64         // Reader retries before using the names list
+
+#define SPOUT_RECORD_EMPTY 0
+#define SPOUT_RECORD_USED  1
+
+// Senders of this version record their process ID in the registry and update
+// a heartbeat time while sending. A sender is alive if the heartbeat is recent,
+// otherwise the process is checked. Earlier senders have no process ID and
+// their information map is opened to check that it still exists.
+#define SPOUT_HEARTBEAT_INTERVAL 1000 // Heartbeat update interval (msec)
+#define SPOUT_HEARTBEAT_TIMEOUT  4000 // Heartbeat age before checking the process (msec)
+#define SPOUT_SWEEP_INTERVAL     1000 // Default interval between sender list checks (msec)
+
+struct SpoutRegistryHeader {	// 32 bytes total
+	uint32_t id;				// 4 bytes : SPOUT_REGISTRY_ID
+	uint32_t capacity;			// 4 bytes : number of records (power of 2)
+	volatile LONG generation;	// 4 bytes : odd while writing, incremented for every change
+	uint32_t count;				// 4 bytes : number of senders
+	uint32_t legacyHash;		// 4 bytes : hash of the names list when written
+	volatile LONG changes;		// 4 bytes : incremented when a sender is created, released,
+								//           changes size or format, or is made active
+	uint32_t reserved[2];		// 8 bytes : unused
+};
+
+struct SpoutRegistryRecord {	// 272 bytes total
+	uint32_t state;				// 4 bytes : SPOUT_RECORD_EMPTY or SPOUT_RECORD_USED
+	uint32_t hash;				// 4 bytes : hash of the name, index of the first record probed
+	uint32_t processId;			// 4 bytes : sender process ID, 0 for earlier versions
+	volatile LONG heartbeat;	// 4 bytes : GetTickCount time of the last sender update
+	char name[SpoutMaxSenderNameLen]; // 256 bytes : sender name
+};
+
+//
+// Senders beyond the capacity of the names list are recorded in registry pages.
+// The "SpoutSenderDirectory" map lists the page maps "SpoutSenderPage_<n>",
+// each of SPOUT_PAGE_RECORDS records. Pages are added when required and are
+// not removed, so a reader opens any pages added since it last read the directory.
+// Page records are written with the registry mutex and generation.
+//
+#define SPOUT_DIRECTORY_ID    0x31445053 // "SPD1"
+#define SPOUT_PAGE_RECORDS    32         // Records in each page
+#define SPOUT_DIRECTORY_PAGES 62         // Maximum number of pages
+
+struct SpoutRegistryDirectory {	// 256 bytes total
+	uint32_t id;				// 4 bytes : SPOUT_DIRECTORY_ID
+	volatile LONG pages;		// 4 bytes : number of pages
+	uint32_t page[SPOUT_DIRECTORY_PAGES]; // 248 bytes : page map numbers
+};
+
+//
+// Sorted list of sender names and information at a registry generation.
+// A snapshot is not changed after it is created and can be retained
+// by the caller. The information is as read when the snapshot was created.
+//
+struct SpoutSenderSnapshot {
+	LONG generation;					// Registry generation, -1 if not from the registry
+	LONG changes;						// Registry change count when the information was read
+	std::vector<std::string> names;		// Sender names in the same order as the names set
+	std::vector<SharedTextureInfo> info;	// Sender information, zero if not available
+};
+
 //
 // GUIDs for additional sender information maps
 // Used for development work
@@ -125,6 +222,14 @@ class SPOUT_DLLEXP spoutSenderNames {
 		int GetSenderIndex(const char* sendername);
 		// Information about a sender from an index into the list
 		bool GetSenderNameInfo(int index, char* sendername, int sendernameMaxSize, unsigned int &width, unsigned int &height, HANDLE &dxShareHandle);
+		// Sorted names and information, re-used until the registry changes
+		std::shared_ptr<const SpoutSenderSnapshot> GetSenderSnapshot();
+		// Count of sender changes for receivers to test instead of the sender list
+		LONG GetChangeCount();
+		// Check the names list and registry for corrupted entries
+		bool CheckSenderNames();
+		// Names list mutex waits by this object
+		bool GetNamesLockStats(SpoutLockStats& stats);
 
 		//
 		// Maximum number of senders allowed in the list
@@ -152,6 +257,10 @@ class SPOUT_DLLEXP spoutSenderNames {
 		bool setSharedInfo (const char* sendername, const SharedTextureInfo* info);
 		// Test for shared info memory map existence
 		bool hasSharedInfo(const char* sendername);
+		// Connected sender info read, re-validated only if changed
+		bool CheckSenderInfo(const char* sendername, SharedTextureInfo* info);
+		// Close the connected sender info map
+		void CloseSenderInfo();
 
 		//
 		// Functions to maintain the active sender
@@ -183,6 +292,11 @@ class SPOUT_DLLEXP spoutSenderNames {
 		bool FindSender   (const char* sendername);
 		// Release orphaned senders
 		void CleanSenders();
+		// Interval between checks for orphaned senders by GetSenderCount (msec)
+		void SetSweepInterval(DWORD dwInterval);
+		DWORD GetSweepInterval();
+		// Update the registry heartbeat of the senders created by this class
+		void UpdateHeartbeat();
 
 protected:
 
@@ -203,8 +317,44 @@ protected:
 		static void readSenderSetFromBuffer(const char* buffer, std::set<std::string>& SenderNames, int maxSenders);
 		static void	writeBufferFromSenderSet(const std::set<std::string>& SenderNames, char *buffer, int maxSenders);
 
+		// Sender registry management
+		bool CreateSenderRegistry();
+		const SpoutRegistryHeader* getSenderRegistry();
+		void syncSenderRegistry();
+		bool readSenderRegistry(std::set<std::string>& SenderNames, LONG* pGeneration = nullptr);
+		bool findSenderRegistry(const char* SenderName, bool &bFound);
+		SpoutRegistryRecord* findRegistryRecord(char* pBuf, const char* SenderName);
+		void setRegistryHeartbeat(const char* SenderName);
+		void signalRegistryChange();
+		static uint32_t senderNameHash(const char* SenderName);
+		static uint32_t senderListHash(const char* buffer, int maxSenders);
+
+		// Registry pages for senders beyond the names list
+		SpoutRegistryDirectory* getRegistryDirectory();
+		int openRegistryPages(bool bCreate = false);
+		SpoutRegistryRecord* getRegistryPage(int index);
+		bool addRegistryPage(const char* SenderName);
+		bool removeRegistryPage(const char* SenderName);
+
 		SpoutSharedMemory m_senderNames;
 		SpoutSharedMemory m_activeSender;
+		SpoutSharedMemory m_senderRegistry;
+		size_t m_registrySize; // Mapped size of the registry
+		SpoutSharedMemory m_senderDirectory;
+		std::vector<SpoutSharedMemory*>* m_pRegistryPages; // Pages opened in directory order
+
+		// Last snapshot returned by GetSenderSnapshot
+		std::shared_ptr<const SpoutSenderSnapshot>* m_pSnapshot;
+
+		// Names from the last registry read and the generation read
+		std::set<std::string>* m_pRegistryNames;
+		LONG m_registryGeneration;
+		DWORD m_listCheckTime; // Time the names list was last compared
+
+		// Sender list check and heartbeat times
+		DWORD m_sweepInterval;
+		DWORD m_sweepTime;
+		DWORD m_heartbeatTime;
 
 		// This should be a unordered_map of sender names ->SharedMemory
 		// to handle multiple inputs and outputs all going through the
@@ -213,6 +363,14 @@ protected:
 		// if the .dll is compiled with something different
 		std::unordered_map<std::string, SpoutSharedMemory*>* m_senders;
 		int m_MaxSenders; // maximum number of senders via registry
+		int m_listSenders; // number of names the names list map can hold
+
+		// Connected sender information for CheckSenderInfo
+		SpoutSharedMemory m_senderInfo;
+		SharedTextureInfo m_senderInfoCache;
+		LONG m_senderInfoCount;
+		DWORD m_senderInfoTime;
+		bool m_bSenderInfoValid;
 
 };
 
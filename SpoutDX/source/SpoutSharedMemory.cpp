@@ -53,6 +53,14 @@
 //	07.12.23 - Remove unused <d3d9.h> from header
 //	Version 2.007.013
 //	Version 2.007.014
+//	18.10.26 - Add Buffer() for unlocked access to values that can be read atomically
+//			 - Open - create the map mutex when first locked instead of every open.
+//			   Add ReadSequenced for readers of maps with a sequence count.
+//			 - Open - record the mapped size, rounded up to the page size,
+//			   instead of zero. Add SpoutMemoryHeader for data segments.
+//			 - Create - record the mapped size of an existing map
+//			   instead of the size requested.
+//			 - Lock - record mutex wait times. Add GetLockStats, ResetLockStats.
 //
 // ====================================================================================
 
@@ -72,6 +80,7 @@ SpoutSharedMemory::SpoutSharedMemory()
 	m_pName = NULL;
 	m_size = 0;
 	m_lockCount = 0;
+	m_lockStats = {};
 }
 
 SpoutSharedMemory::~SpoutSharedMemory()
@@ -165,6 +174,14 @@ SpoutCreateResult SpoutSharedMemory::Create(const char* name, int size)
 
 	m_size = size;
 
+	// An existing map has the size it was created with.
+	// The mapped region size is that size rounded up to the page size.
+	if (alreadyExists) {
+		MEMORY_BASIC_INFORMATION mbi={};
+		if (VirtualQuery(m_pBuffer, &mbi, sizeof(mbi)) != 0)
+			m_size = (int)mbi.RegionSize;
+	}
+
 	return alreadyExists ? SPOUT_ALREADY_EXISTS : SPOUT_CREATE_SUCCESS;
 
 }
@@ -179,7 +196,7 @@ bool SpoutSharedMemory::Open(const char* name)
 
 	if (m_hMap)	{
 		assert(strcmp(name, m_pName) == 0);
-		assert(m_pBuffer && m_hMutex);
+		assert(m_pBuffer);
 		return true;
 	}
 
@@ -194,26 +211,17 @@ bool SpoutSharedMemory::Open(const char* name)
 		return false;
 	}
 
-	std::string	mutexName;
-	mutexName = name;
-	mutexName += "_mutex";
-
-	m_hMutex = CreateMutexA(NULL, false, mutexName.c_str());
-	if (!m_hMutex) {
-		Close();
-		return false;
-	}
-
-	// If the mutex object existed before this function call,
-	// GetLastError returns ERROR_ALREADY_EXISTS. 
-	// Clear the error to avoid detection elsewhere.
-	SetLastError(NO_ERROR);
-
+	// The mutex is created by Lock when it is first needed.
+	// Readers using ReadSequenced do not lock.
 	m_pName = _strdup(name);
 
-	// OpenFileMapping/MapViewOfFile do not return the map size
-	// Only the process that creates the shared memory can save it's size.
-	m_size = 0;
+	// OpenFileMapping/MapViewOfFile do not return the map size.
+	// The mapped region size is the size created rounded up to the page size.
+	MEMORY_BASIC_INFORMATION mbi={};
+	if (VirtualQuery(m_pBuffer, &mbi, sizeof(mbi)) != 0)
+		m_size = (int)mbi.RegionSize;
+	else
+		m_size = 0;
 
 	return true;
 
@@ -254,18 +262,28 @@ void SpoutSharedMemory::Close()
 char* SpoutSharedMemory::Lock()
 {
 	assert(m_lockCount >= 0);
-	assert(m_hMutex);
 
 	if(m_lockCount < 0) {
 		return NULL;
 	}
 
-	if(!m_hMutex) {
+	if(!m_pBuffer) {
 		return NULL;
 	}
 
-	if(!m_pBuffer) {
-		return NULL;
+	// Create the mutex of a map that has been opened
+	if (!m_hMutex) {
+		std::string	mutexName;
+		mutexName = m_pName;
+		mutexName += "_mutex";
+		m_hMutex = CreateMutexA(NULL, false, mutexName.c_str());
+		if (!m_hMutex) {
+			return NULL;
+		}
+		// If the mutex object existed before this function call,
+		// GetLastError returns ERROR_ALREADY_EXISTS. 
+		// Clear the error to avoid detection elsewhere.
+		SetLastError(NO_ERROR);
 	}
 
 	if (m_lockCount > 0) {
@@ -274,8 +292,15 @@ char* SpoutSharedMemory::Lock()
 		return m_pBuffer;
 	}
 
+	const LONG64 start = GetClockTicks();
 	const DWORD waitResult = WaitForSingleObject(m_hMutex, 67);
+	const double wait = ClockTicksToMilliseconds(GetClockTicks() - start)*1000.0;
+	m_lockStats.locks++;
+	m_lockStats.totalwait += wait;
+	if (wait > m_lockStats.maxwait)
+		m_lockStats.maxwait = wait;
 	if (waitResult != WAIT_OBJECT_0) {
+		m_lockStats.timeouts++;
 		return nullptr;
 	}
 
@@ -300,6 +325,71 @@ void SpoutSharedMemory::Unlock()
 	}
 }
 
+//---------------------------------------------------------
+// Function: GetLockStats
+// Mutex waits by Lock since the object was created or reset.
+//
+// Number of waits, waits that timed out or failed,
+// total and longest wait time in microseconds.
+// Nested locks do not wait and are not counted.
+// Returns false if there have been no waits.
+bool SpoutSharedMemory::GetLockStats(SpoutLockStats& stats)
+{
+	stats = m_lockStats;
+	return (m_lockStats.locks > 0);
+}
+
+//---------------------------------------------------------
+// Function: ResetLockStats
+// Clear the mutex wait statistics
+void SpoutSharedMemory::ResetLockStats()
+{
+	m_lockStats = {};
+}
+
+//---------------------------------------------------------
+// Function: Buffer
+// Return the buffer of an open map without locking.
+// Only for values that the writer updates atomically.
+const char* SpoutSharedMemory::Buffer()
+{
+	return m_pBuffer;
+}
+
+//---------------------------------------------------------
+// Function: ReadSequenced
+// Copy from an open map without locking.
+//
+// For maps with a sequence count that writers increment, while holding
+// the mutex, before and after writing. The count is odd during a write.
+// The copy is repeated if the count is odd or changes during the copy
+// so that any number of readers can proceed in parallel.
+// Returns false if a consistent copy could not be made and the
+// caller should lock the map instead.
+bool SpoutSharedMemory::ReadSequenced(void* dest, int offset, int size, int sequenceOffset)
+{
+	if (!m_pBuffer || !dest || offset < 0 || size <= 0 || sequenceOffset < 0)
+		return false;
+
+	const volatile LONG* pSequence = (const volatile LONG*)(m_pBuffer + sequenceOffset);
+
+	for (int i = 0; i < SPOUT_SEQUENCE_RETRIES; i++) {
+		const LONG sequence = *pSequence;
+		if (sequence & 1) {
+			// A write is in progress
+			YieldProcessor();
+			continue;
+		}
+		MemoryBarrier();
+		memcpy(dest, m_pBuffer + offset, (size_t)size);
+		MemoryBarrier();
+		if (*pSequence == sequence)
+			return true;
+	}
+
+	return false;
+}
+
 //---------------------------------------------------------
 // Function: Name
 // Return the name of an existing map
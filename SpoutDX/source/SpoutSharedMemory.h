@@ -42,6 +42,64 @@
 
 using namespace spoututils;
 
+// Reader retries before a sequenced read fails
+#define SPOUT_SEQUENCE_RETRIES 64
+
+//
+// Header of a data segment, such as a sender memory buffer.
+// Writers increment the sequence before and after writing so that
+// readers can copy without locking. If a writer needs a larger buffer,
+// a new segment is created and "next" is set to its number.
+// Readers then open the new segment instead.
+//
+#define SPOUT_MEMORY_ID      0x314D5053 // "SPM1"
+#define SPOUT_MEMORY_VERSION 1
+
+struct SpoutMemoryHeader {		// 32 bytes total
+	uint32_t id;				// 4 bytes : SPOUT_MEMORY_ID
+	uint32_t version;			// 4 bytes : SPOUT_MEMORY_VERSION
+	uint32_t capacity;			// 4 bytes : bytes available for data
+	uint32_t used;				// 4 bytes : bytes written by the last write
+	volatile LONG sequence;		// 4 bytes : odd while writing
+	volatile LONG next;			// 4 bytes : number of the segment that replaces this one, 0 if none
+	uint32_t reserved[2];		// 8 bytes : unused
+};
+
+//
+// Frame metadata records "<sender>_meta"
+//
+// A header followed by a ring of records, each keyed by a sender
+// frame number. The header occupies one cache line so that a receiver
+// can check for a new record with a single read.
+//
+#define SPOUT_METADATA_ID    0x31465053 // "SPF1"
+#define SPOUT_METADATA_SLOTS 4
+
+struct SpoutMetadataHeader {
+	uint32_t id;				// 4 bytes : SPOUT_METADATA_ID
+	uint32_t slots;				// 4 bytes : number of records
+	uint32_t slotsize;			// 4 bytes : bytes available for data in each record
+	volatile LONG frame;		// 4 bytes : frame number of the last record written
+	uint32_t reserved[12];		// 48 bytes
+}; // 64 bytes
+
+struct SpoutMetadataRecord {
+	volatile LONG sequence;		// 4 bytes : write sequence, odd while writing
+	volatile LONG frame;		// 4 bytes : sender frame number
+	uint32_t length;			// 4 bytes : bytes of data written
+	uint32_t reserved;			// 4 bytes
+}; // 16 bytes followed by slotsize bytes of data
+
+//
+// Map mutex waits by Lock
+//
+struct SpoutLockStats {
+	long long locks;		// Mutex waits
+	long long timeouts;		// Waits that timed out or failed
+	double totalwait;		// Total wait time (microseconds)
+	double maxwait;			// Longest wait time (microseconds)
+};
+
 //
 // Result of memory segment creation
 //
@@ -74,10 +132,21 @@ public:
 	// Unlock a map
 	void Unlock();
 
+	// Mutex wait times of Lock
+	bool GetLockStats(SpoutLockStats& stats);
+	void ResetLockStats();
+
+	// Buffer of an open map without locking
+	const char* Buffer();
+
+	// Copy from a map without locking if the writer maintains a sequence count
+	bool ReadSequenced(void* dest, int offset, int size, int sequenceOffset);
+
 	// Name of an existing map
 	const char* Name();
 	
 	// Size of an existing map
+	// Size created, or the mapped size of a map that has been opened
 	int Size();
 
 	// Print map information for debugging
@@ -89,6 +158,7 @@ private:
 	HANDLE m_hMap; // Map handle
 	HANDLE m_hMutex; // Mutex for map access
 	int m_lockCount; // Map access lock count
+	SpoutLockStats m_lockStats; // Map access mutex waits
 	char* m_pName; // Map name
 	int m_size; // Map size
 
@@ -225,6 +225,10 @@
 		09.02.25 - Remove debug comments for MB_USERBUTTON (no longer used)
 		17.02.25 - Adjust combo box width to the longest item string
 				   Use CBS_DROPDOWNLIST style for list only
+		18.10.26 - Add monotonic clock functions GetClockTicks, GetClockFrequency
+				   and conversions to REFERENCE_TIME and milliseconds.
+				   Add a test clock that advances only when the caller sets it.
+				   StartCounter and GetCounter use the clock.
 
 */
 
@@ -264,8 +268,12 @@ namespace spoututils {
 	std::chrono::steady_clock::time_point end;
 #endif
 	// PC timer
-	double PCFreq = 0.0;
 	__int64 CounterStart = 0;
+	// Monotonic clock
+	long long ClockFrequency = 0; // QueryPerformanceFrequency, fixed at system boot
+	bool bTestClock = false;
+	long long TestClockFrequency = 0;
+	volatile LONG64 TestClockTicks = 0;
 	double startcount = 0.0;
 	double endcount = 0.0;
 	double m_FrameStart = 0.0;
@@ -1611,33 +1619,129 @@ namespace spoututils {
 	// Set counter start
 	// Used instead of std::chrono for Visual Studio before VS2015
 	//
-	// Information on using QueryPerformanceFrequency for timing
-	// https://docs.microsoft.com/en-us/windows/desktop/SysInfo/acquiring-high-resolution-time-stamps
-	//
 	void StartCounter()
 	{
-		LARGE_INTEGER li;
-		if (QueryPerformanceFrequency(&li)) {
-			// Find the PC frequency if not done yet
-			if (PCFreq < 0.0001)
-				PCFreq = static_cast<double>(li.QuadPart) / 1000.0;
-			// Get the counter start
-			QueryPerformanceCounter(&li);
-			CounterStart = li.QuadPart;
-		}
+		CounterStart = GetClockTicks();
 	}
 
 	// -----------------------------------------------
 	// Return msec elapsed since counter start
 	double GetCounter()
 	{
-		LARGE_INTEGER li;
-		if (QueryPerformanceCounter(&li)) {
-			return static_cast<double>(li.QuadPart - CounterStart) / PCFreq;
+		return ClockTicksToMilliseconds(GetClockTicks() - CounterStart);
+	}
+
+	//
+	// Group: Monotonic clock
+	//
+	// QueryPerformanceCounter ticks for all SDK timing.
+	//
+	// The frequency is fixed at system boot and is read once, so a read
+	// is a single QueryPerformanceCounter call from any thread.
+	//
+	// Information on using QueryPerformanceFrequency for timing
+	// https://docs.microsoft.com/en-us/windows/desktop/SysInfo/acquiring-high-resolution-time-stamps
+	//
+	// A test clock can replace it so that timing code gives the same
+	// result every run. The test clock advances only by AdvanceTestClock,
+	// or by ClockSleep instead of sleeping.
+	//
+
+	// ---------------------------------------------------------
+	// Function: GetClockTicks
+	// Clock ticks (QueryPerformanceCounter, or the test clock if enabled)
+	long long GetClockTicks()
+	{
+		if (bTestClock)
+			return TestClockTicks;
+		LARGE_INTEGER li{};
+		QueryPerformanceCounter(&li);
+		return li.QuadPart;
+	}
+
+	// ---------------------------------------------------------
+	// Function: GetClockFrequency
+	// Clock ticks per second
+	long long GetClockFrequency()
+	{
+		if (bTestClock)
+			return TestClockFrequency;
+		if (ClockFrequency == 0) {
+			LARGE_INTEGER li{};
+			QueryPerformanceFrequency(&li);
+			ClockFrequency = li.QuadPart;
 		}
-		else {
+		return ClockFrequency;
+	}
+
+	// ---------------------------------------------------------
+	// Function: ClockTicksToReferenceTime
+	// Clock ticks to 100 nanosecond units (REFERENCE_TIME).
+	// Seconds and remainder are converted separately to avoid overflow.
+	long long ClockTicksToReferenceTime(long long ticks)
+	{
+		const long long frequency = GetClockFrequency();
+		if (frequency <= 0)
+			return 0;
+		return (ticks/frequency)*10000000LL + ((ticks%frequency)*10000000LL)/frequency;
+	}
+
+	// ---------------------------------------------------------
+	// Function: ClockTicksToMilliseconds
+	// Clock ticks to milliseconds
+	double ClockTicksToMilliseconds(long long ticks)
+	{
+		const long long frequency = GetClockFrequency();
+		if (frequency <= 0)
 			return 0.0;
-		}
+		return static_cast<double>(ticks)*1000.0/static_cast<double>(frequency);
+	}
+
+	// ---------------------------------------------------------
+	// Function: MillisecondsToClockTicks
+	// Milliseconds to clock ticks
+	long long MillisecondsToClockTicks(double msec)
+	{
+		return static_cast<long long>(msec*static_cast<double>(GetClockFrequency())/1000.0);
+	}
+
+	// ---------------------------------------------------------
+	// Function: ClockSleep
+	// Sleep, or advance the test clock if enabled
+	void ClockSleep(DWORD dwMilliseconds)
+	{
+		if (bTestClock)
+			AdvanceTestClock(MillisecondsToClockTicks(static_cast<double>(dwMilliseconds)));
+		else
+			Sleep(dwMilliseconds);
+	}
+
+	// ---------------------------------------------------------
+	// Function: EnableTestClock
+	// Test clock that advances only by AdvanceTestClock or ClockSleep.
+	// Starts at zero with the frequency given (default 10MHz).
+	void EnableTestClock(bool bEnable, long long frequency)
+	{
+		TestClockFrequency = (frequency > 0) ? frequency : 10000000LL;
+		TestClockTicks = 0;
+		bTestClock = bEnable;
+	}
+
+	// ---------------------------------------------------------
+	// Function: AdvanceTestClock
+	// Advance the test clock
+	void AdvanceTestClock(long long ticks)
+	{
+		if (ticks > 0)
+			InterlockedExchangeAdd64(&TestClockTicks, ticks);
+	}
+
+	// ---------------------------------------------------------
+	// Function: IsTestClock
+	// Test clock enabled
+	bool IsTestClock()
+	{
+		return bTestClock;
 	}
 
 	//
@@ -351,6 +351,29 @@ namespace spoututils {
 	void SPOUT_DLLEXP StartCounter();
 	double SPOUT_DLLEXP GetCounter();
 
+	//
+	// Monotonic clock
+	//
+
+	// Clock ticks (QueryPerformanceCounter, or the test clock if enabled)
+	long long SPOUT_DLLEXP GetClockTicks();
+	// Clock ticks per second
+	long long SPOUT_DLLEXP GetClockFrequency();
+	// Clock ticks to 100 nanosecond units (REFERENCE_TIME)
+	long long SPOUT_DLLEXP ClockTicksToReferenceTime(long long ticks);
+	// Clock ticks to milliseconds
+	double SPOUT_DLLEXP ClockTicksToMilliseconds(long long ticks);
+	// Milliseconds to clock ticks
+	long long SPOUT_DLLEXP MillisecondsToClockTicks(double msec);
+	// Sleep, or advance the test clock if enabled
+	void SPOUT_DLLEXP ClockSleep(DWORD dwMilliseconds);
+	// Test clock that advances only by AdvanceTestClock or ClockSleep
+	void SPOUT_DLLEXP EnableTestClock(bool bEnable = true, long long frequency = 10000000);
+	// Advance the test clock
+	void SPOUT_DLLEXP AdvanceTestClock(long long ticks);
+	// Test clock enabled
+	bool SPOUT_DLLEXP IsTestClock();
+
 	//
 	// Private functions
 	//
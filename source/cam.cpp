@@ -319,6 +319,50 @@
 			   Update version number in cam.rc to 2.034
 			   Test with revised SpoutCamSettings - dialog version
 			   Version 2.034
+	18.10.26   FillBuffer - re-deliver the last frame received if the sender frame
+			   is unchanged. DirectShow samples rotate, so the sample buffer otherwise
+			   holds stale data. Also used if a starting sender has closed.
+			   Log new/repeated frame counts when the receiver is released.
+			   Add event driven receive option - registry "framesync".
+			   FillBuffer waits for the sender to produce a frame instead of sleeping,
+			   if the sender frame count is available.
+			   Check the active sender only if not connected. ReceiveImage detects
+			   sender change or close from the connected sender information.
+			   10 bit, 16 bit and floating point sender textures are converted
+			   by ReceiveImage.
+			   If not connected, check for the active sender only if the sender
+			   change count has changed, or at one second intervals.
+			   Add frame rate conversion option - registry "frameconvert".
+			   Keep the last sender frames with the sender frame time and
+			   deliver the nearest frame or a blend of two frames
+			   for the output frame time.
+			   The history holds the sender time recorded when each frame was
+			   copied, and the output time is the sample start time.
+			   Add fps selection 6 - sender frame rate. The media type starts
+			   with the standard rate nearest to the sender frame rate and
+			   FillBuffer delivers a sample for each new sender frame.
+			   Samples are paced at the measured sender frame period, which
+			   is kept apart from the media type frame time, and FillBuffer
+			   waits for the sender frame only within the time to the next sample.
+			   Add texture access wait option - registry "accesswait".
+			   With zero, FillBuffer does not wait if the sender holds the
+			   texture and re-delivers the last frame. Log access statistics
+			   when the receiver is released.
+			   Use the SpoutUtils clock for FillBuffer if there is no
+			   DirectShow clock, and for frame rate conversion.
+			   IAMDroppedFrames - count output frames that are late, sender
+			   frames that are skipped and frames where texture access timed out.
+			   GetDroppedInfo returns the numbers of recent dropped frames - output
+			   sample numbers for late and timed out frames and sender frame
+			   numbers for skipped frames. GetAverageFrameSize returns the
+			   average size of the frames delivered.
+			   Add sender time option - registry "sendertime". Sample times are
+			   the time the sender produced the frame, converted to stream time
+			   with the graph clock, and the media time is the sender frame number.
+			   The time and number are those of the frame in the pixels, which
+			   ReceiveImage reads one frame behind the sender frame count.
+			   Sender frames skipped because the output frame rate is lower
+			   than the sender are counted separately and not as dropped.
 
 
 */
@@ -581,6 +625,14 @@ CVCamStream::CVCamStream(HRESULT *phr, CVCam *pParent, LPCWSTR pPinName) :
 	bMemoryMode		= false; // Default mode is texture, true means memoryshare
 	bInvert         = true;  // Flip vertically
 	bInitialized	= false; // Spoutcam receiver
+	bFrameSync		= false; // Event driven receive
+	bSenderFps		= false; // Sender frame rate
+	dwFpsCheck		= 0;
+	m_rtSenderPeriod = 0;
+	m_rtPacingOffset = 0;
+	bSenderFound	= false; // Active sender check
+	SenderChanges	= 0;
+	dwSenderCheck	= 0;
 	g_Width			= 640;	 // give it an initial size - this will be changed if a sender is running at start
 	g_Height		= 480;
 	g_SenderName[0] = 0;
@@ -685,6 +737,49 @@ CVCamStream::CVCamStream(HRESULT *phr, CVCam *pParent, LPCWSTR pPinName) :
 	g_SenderStart[0] = 0;
 	ReadPathFromRegistry(HKEY_CURRENT_USER, "Software\\Leading Edge\\SpoutCam", "senderstart", g_SenderStart);
 
+	//
+	// Event driven receive
+	//
+	// Wait for the sender to produce a new frame rather than
+	// sleeping until the next frame time (default off).
+	//
+	DWORD dwFrameSync = 0;
+	ReadDwordFromRegistry(HKEY_CURRENT_USER, "Software\\Leading Edge\\SpoutCam", "framesync", &dwFrameSync);
+	bFrameSync = (dwFrameSync > 0);
+
+	//
+	// Frame rate conversion
+	//
+	// Select the sender frame nearest to the output frame time (1)
+	// or blend the two frames either side of it (2) (default off).
+	// Requires a sender with a frame control block.
+	//
+	dwConvert = 0;
+	ReadDwordFromRegistry(HKEY_CURRENT_USER, "Software\\Leading Edge\\SpoutCam", "frameconvert", &dwConvert);
+	if (dwConvert > 2) dwConvert = 2;
+
+	//
+	// Texture access wait
+	//
+	// Milliseconds to wait if the sender holds the shared texture (default 67).
+	// With zero, the last frame is delivered instead of waiting.
+	//
+	DWORD dwAccessWait = SPOUT_ACCESS_TIMEOUT;
+	ReadDwordFromRegistry(HKEY_CURRENT_USER, "Software\\Leading Edge\\SpoutCam", "accesswait", &dwAccessWait);
+	receiver.SetAccessTimeout(dwAccessWait);
+
+	//
+	// Sender time
+	//
+	// Set sample times from the time the sender produced each frame
+	// and the media time to the sender frame number (default off).
+	// Requires a sender with a frame control block.
+	//
+	DWORD dwSenderTime = 0;
+	ReadDwordFromRegistry(HKEY_CURRENT_USER, "Software\\Leading Edge\\SpoutCam", "sendertime", &dwSenderTime);
+	bSenderTime = (dwSenderTime > 0);
+	m_rtSenderStart = -1;
+
 	/*
 	printf("dwFps        = %d\n", dwFps);
 	printf("dwResolution = %d\n", dwResolution);
@@ -703,7 +798,32 @@ CVCamStream::CVCamStream(HRESULT *phr, CVCam *pParent, LPCWSTR pPinName) :
 
 	NumDroppedFrames = 0LL;
 	NumFrames = 0LL;
-
+	NumLateFrames = 0LL;
+	NumSkippedFrames = 0LL;
+	NumDecimatedFrames = 0LL;
+	NumTimeoutFrames = 0LL;
+	NumFrameBytes = 0LL;
+	LateSlots = 0LL;
+	LastSenderFrame = 0;
+	LastSenderSample = 0LL;
+	LastAccessTimeouts = 0LL;
+	ZeroMemory(m_DroppedFrames, sizeof(m_DroppedFrames));
+	m_DroppedCount = 0;
+	m_DroppedIndex = 0;
+	NumNewFrames = 0LL;
+	NumRepeatedFrames = 0LL;
+
+	m_pLastFrame = nullptr;
+	m_LastFrameSize = 0;
+	bLastFrame = false;
+
+	for (int i = 0; i < SPOUTCAM_HISTORY; i++) {
+		m_pHistory[i] = nullptr;
+		m_HistoryTime[i] = 0;
+	}
+	m_HistorySize = 0;
+	m_HistoryCount = 0;
+	m_HistoryIndex = 0;
 
 }
 
@@ -716,6 +836,8 @@ void CVCamStream::SetFps(DWORD dwFps)
 	// 3 - 30fps =  333333 (default)
 	// 4 - 50fps =  200000
 	// 5 - 60fps =  166667
+	// 6 - sender fps - nearest of the above, 30fps if no sender
+	bSenderFps = false;
 	switch(dwFps) {
 		case 0 :
 			g_FrameTime = 1000000; // 10
@@ -735,12 +857,84 @@ void CVCamStream::SetFps(DWORD dwFps)
 		case 5 :
 			g_FrameTime = 166667; // 60
 			break;
+		case 6 :
+			{
+				// Frame period published by the sender
+				g_FrameTime = 333333; // 30 if no sender
+				char name[256]{};
+				if (g_SenderStart[0])
+					strcpy_s(name, 256, g_SenderStart);
+				else
+					receiver.GetActiveSender(name);
+				REFERENCE_TIME rtPeriod = 0;
+				if (name[0]) {
+					char controlname[256]{};
+					sprintf_s(controlname, 256, "%s_Count_Control", name);
+					SpoutSharedMemory control;
+					if (control.Open(controlname)) {
+						// The fields are written atomically, so read without the map mutex
+						const SpoutFrameControl* pControl = (const SpoutFrameControl*)control.Buffer();
+						if (pControl && pControl->id == SPOUT_FRAMECONTROL_ID && pControl->period > 0 && pControl->frequency > 0) {
+							const double fps = (double)pControl->frequency/(double)pControl->period;
+							SetFps(NearestFps(fps));
+							rtPeriod = (REFERENCE_TIME)(10000000.0/fps);
+						}
+						control.Close();
+					}
+				}
+				// Samples are paced at the sender frame period
+				m_rtSenderPeriod = (rtPeriod > 0) ? rtPeriod : g_FrameTime;
+				m_rtPacingOffset = 0;
+				bSenderFps = true;
+			}
+			break;
 		default :
 			g_FrameTime = 333333; // default 30
 			break;
 	}
 }
 
+// Index of the standard frame rate nearest to the fps given
+DWORD CVCamStream::NearestFps(double fps)
+{
+	const double rates[6] = { 10.0, 15.0, 25.0, 30.0, 50.0, 60.0 };
+	DWORD index = 3;
+	if (fps > 0.0) {
+		for (DWORD i = 0; i < 6; i++) {
+			if (fabs(fps - rates[i]) < fabs(fps - rates[index]))
+				index = i;
+		}
+	}
+	return index;
+}
+
+// Follow a change of sender frame rate for sample pacing.
+// The connected media type and g_FrameTime keep the rate they started with.
+// The sample schedule is offset so that it continues from the current
+// sample at the new period without counting late frames.
+void CVCamStream::UpdateSenderFps()
+{
+	const DWORD dwNow = timeGetTime();
+	if (dwFpsCheck != 0 && (dwNow - dwFpsCheck) < 1000)
+		return;
+	dwFpsCheck = dwNow;
+
+	SpoutFrameStats stats{};
+	if (!receiver.GetSenderFrameStats(stats) || stats.frames < SPOUT_FPS_SETTLE || stats.fps <= 0.0)
+		return;
+
+	if (m_rtSenderPeriod <= 0)
+		m_rtSenderPeriod = g_FrameTime;
+	const REFERENCE_TIME rtPeriod = (REFERENCE_TIME)(10000000.0/stats.fps);
+	// Ignore changes less than 1%
+	if (llabs(rtPeriod - m_rtSenderPeriod) * 100LL < m_rtSenderPeriod)
+		return;
+
+	m_rtPacingOffset += NumFrames*(m_rtSenderPeriod - rtPeriod);
+	m_rtSenderPeriod = rtPeriod;
+	SpoutLogNotice("SpoutCam - sender frame rate %.2f fps, sample period %lld", stats.fps, rtPeriod);
+}
+
 void CVCamStream::SetResolution(DWORD dwResolution)
 {
 
@@ -827,6 +1021,14 @@ CVCamStream::~CVCamStream()
 	if (bDXinitialized)
 		receiver.CloseDirectX11();
 
+	if (m_pLastFrame)
+		delete[] m_pLastFrame;
+
+	for (int i = 0; i < SPOUTCAM_HISTORY; i++) {
+		if (m_pHistory[i])
+			delete[] m_pHistory[i];
+	}
+
 	// End timer precision
 	timeEndPeriod(g_caps.wPeriodMin);
 
@@ -887,6 +1089,9 @@ HRESULT CVCamStream::FillBuffer(IMediaSample *pms)
 	// The current time is the sample's start.
 	REFERENCE_TIME rtNow = m_rtLastTime;
 	REFERENCE_TIME avgFrameTime = g_FrameTime; // Desired average frame time is set by the user
+	// Sender frame rate - paced at the measured sender frame period
+	if (bSenderFps && m_rtSenderPeriod > 0)
+		avgFrameTime = m_rtSenderPeriod;
 
 	// Create some working info
 	REFERENCE_TIME rtDelta, rtDelta2 = 0LL; // delta for dropped, delta 2 for sleep.
@@ -894,21 +1099,13 @@ HRESULT CVCamStream::FillBuffer(IMediaSample *pms)
 	//
 	// What time is it REALLY ???
 	//
-	m_pParent->GetSyncSource(&m_pClock);
-	if (m_pClock) {
-		m_pClock->GetTime(&refSync1);
-		m_pClock->Release();
-	}
-	else {
-		// Some programs do not implement the DirectShow clock and can crash if assumed
-		// so we can use TimeGetTime instead. Only millisecond precision, but so is Sleep.
-		refSync1 = (REFERENCE_TIME)timeGetTime() * 10000LL; // Cast before the multiply to avoid overflow
-	}
+	refSync1 = GetClockTime();
 
 	if (NumFrames <= 1)	{
 		// initiate values
 		refStart = refSync1; // FirstFrame No Drop
 		refSync2 = 0;
+		m_rtPacingOffset = 0;
 	}
 
 	rtNow = m_rtLastTime;
@@ -916,19 +1113,40 @@ HRESULT CVCamStream::FillBuffer(IMediaSample *pms)
 
 	// IAMDropppedFrame. We only have avgFrameTime to generate image.
 	// Find generated stream time and compare to real elapsed time.
-	rtDelta = ((refSync1 - refStart) - (((NumFrames)*avgFrameTime) - avgFrameTime));
+	// The offset continues the schedule if the sender frame period changes.
+	rtDelta = ((refSync1 - refStart) - (m_rtPacingOffset + ((NumFrames)*avgFrameTime) - avgFrameTime));
 	if (rtDelta - refSync2 < 0)	{
 		// we are early
 		rtDelta2 = rtDelta - refSync2;
 		DWORD dwSleep = (DWORD)abs(rtDelta2 / 10000LL);
-		if (dwSleep >= 1)
+		if ((bFrameSync || bSenderFps) && bInitialized && receiver.CanWaitNewFrame()) {
+			// Event driven receive, or sender frame rate.
+			// Wait for the sender to produce a frame instead of sleeping for
+			// the whole interval, so that it is sent as soon as it is published.
+			// Sleep any time more than one frame period early to hold the frame rate.
+			// Without a sender frame count the wait would return at once,
+			// so sleep for the whole interval below instead.
+			const DWORD dwPeriod = (DWORD)(avgFrameTime / 10000LL);
+			if (dwSleep > dwPeriod) {
+				Sleep(dwSleep - dwPeriod);
+				dwSleep = dwPeriod;
+			}
+			if (dwSleep >= 1)
+				receiver.WaitNewFrame(dwSleep);
+		}
+		else if (dwSleep >= 1) {
 			Sleep(dwSleep);
+		}
 	}
-	else if (rtDelta / avgFrameTime > NumDroppedFrames)	{	
+	else if (rtDelta / avgFrameTime > LateSlots)	{	
 		// new dropped frame
-		NumDroppedFrames = rtDelta / avgFrameTime;
+		// Frame times passed since the last late frame
+		const long long late = rtDelta / avgFrameTime - LateSlots;
+		LateSlots = rtDelta / avgFrameTime;
+		NumLateFrames += late;
+		AddDroppedFrames(late, NumFrames);
 		// Figure new RT for sleeping
-		refSync2 = NumDroppedFrames * avgFrameTime;
+		refSync2 = LateSlots * avgFrameTime;
 		// Our time stamping needs adjustment.
 		// Find total real stream time from start time.
 		rtNow = refSync1 - refStart;
@@ -974,11 +1192,24 @@ HRESULT CVCamStream::FillBuffer(IMediaSample *pms)
 	} // endif !bDXinitialized
 	
 	// Is anything running at all ?
-	if (!receiver.GetActiveSender(g_ActiveSender)) {
+	// Once connected, ReceiveImage detects whether the sender has closed.
+	// Otherwise look for the active sender only if senders have changed,
+	// or at one second intervals for earlier senders that do not signal changes.
+	if (!receiver.IsConnected()) {
+		const long changes = receiver.GetSenderChanges();
+		const DWORD dwNow = timeGetTime();
+		if (dwSenderCheck == 0 || changes != SenderChanges || (dwNow - dwSenderCheck) >= 1000) {
+			SenderChanges = changes;
+			dwSenderCheck = dwNow;
+			bSenderFound = receiver.GetActiveSender(g_ActiveSender);
+		}
+	}
+	if (!receiver.IsConnected() && !bSenderFound) {
 		// Quit now if a starting sender has started but
 		// has now closed. Wait for it to open again.
 		// The last frame is frozen instead of showing static.
 		if (bInitialized && g_SenderStart[0]) {
+			CopyLastFrame(pData, imagesize);
 			return NOERROR;
 		}
 		// Otherwise release and show static
@@ -989,7 +1220,7 @@ HRESULT CVCamStream::FillBuffer(IMediaSample *pms)
 
 	// DirectX is initialized OK
 	// Get bgr pixels from the sender bgra shared texture
-	// 16 bit or floating point textures not supported
+	// 10 bit, 16 bit and floating point textures are converted to 8 bit bgr
 	// ReceiveImage handles sender detection, connection and copy of pixels
 	if (receiver.ReceiveImage(pData, g_Width, g_Height, true, bInvert)) {
 		// bRGB = true : set rgb(i.e. not rgba data), bInvert = true : flip user setting
@@ -1004,13 +1235,39 @@ HRESULT CVCamStream::FillBuffer(IMediaSample *pms)
 				WritePathToRegistry(HKEY_CURRENT_USER, "Software\\Leading Edge\\SpoutCam", "sendername", g_SenderName);
 			}
 		}
+		if (receiver.IsFrameUnchanged()) {
+			// The sender has not produced a new frame and pData has not been written.
+			// The sample buffer could be any previous one, so re-deliver the last frame.
+			CopyLastFrame(pData, imagesize);
+			NumRepeatedFrames++;
+			CountReceivedFrame(false);
+		}
+		else {
+			CountReceivedFrame(true);
+			SaveLastFrame(pData, imagesize);
+			if (dwConvert > 0)
+				AddHistoryFrame(pData, imagesize);
+			if (bSenderFps)
+				UpdateSenderFps();
+			NumNewFrames++;
+		}
+		// Replace with the frame for the sample time
+		bool bConverted = false;
+		if (dwConvert > 0)
+			bConverted = ConvertFrame(pData, imagesize, rtNow);
+		// Replace the sample times set above.
+		// A converted frame is already the frame for the sample time.
+		if (bSenderTime && !bConverted)
+			SetSenderTime(pms, receiver.IsFrameUnchanged() ? 0 : receiver.GetImageTime(), receiver.GetImageFrame());
 		bInitialized = true;
 		NumFrames++;
+		NumFrameBytes += imagesize;
 		return NOERROR;
 	}
 	else {
 		// Return if waiting for a starting sender that has closed.
 		if (bInitialized && g_SenderStart[0]) {
+			CopyLastFrame(pData, imagesize);
 			return NOERROR;
 		}
 		// Release the receiver 
@@ -1026,19 +1283,274 @@ ShowStatic :
 		pData[l] = (char)xorshiftRand(); // fast rand();
 
 	NumFrames++;
+	NumFrameBytes += lDataLen;
 
 	return NOERROR;
 
 } // FillBuffer
 
 
+// DirectShow clock time, or the SpoutUtils clock if there is no clock
+REFERENCE_TIME CVCamStream::GetClockTime()
+{
+	REFERENCE_TIME rtClock = 0;
+	m_pParent->GetSyncSource(&m_pClock);
+	if (m_pClock) {
+		m_pClock->GetTime(&rtClock);
+		m_pClock->Release();
+	}
+	else {
+		// Some programs do not implement the DirectShow clock and can crash if assumed
+		// so use the monotonic clock in 100 nanosecond units instead.
+		rtClock = (REFERENCE_TIME)ClockTicksToReferenceTime(GetClockTicks());
+	}
+	return rtClock;
+}
+
 // Conditionally release receiver and reset flag
 void CVCamStream::ReleaseCamReceiver()
 {
 	if (bInitialized) {
+		if (NumNewFrames > 0) {
+			SpoutLogNotice("SpoutCam - %lld new, %lld repeated frames (%.1f%% repeated)",
+				NumNewFrames, NumRepeatedFrames,
+				100.0*(double)NumRepeatedFrames/(double)(NumNewFrames+NumRepeatedFrames));
+		}
+		if (NumDroppedFrames > 0) {
+			SpoutLogNotice("SpoutCam - %lld dropped frames (%lld late, %lld skipped, %lld access timeout)",
+				NumDroppedFrames, NumLateFrames, NumSkippedFrames, NumTimeoutFrames);
+		}
+		if (NumDecimatedFrames > 0) {
+			SpoutLogNotice("SpoutCam - %lld sender frames not required for the output frame rate",
+				NumDecimatedFrames);
+		}
+		SpoutAccessStats stats{};
+		if (receiver.GetAccessStats(stats)) {
+			SpoutLogNotice("SpoutCam - texture access %lld, %lld timeout, mean wait %.1f usec, max %.1f usec",
+				stats.waits, stats.timeouts, stats.totalwait/(double)stats.waits, stats.maxwait);
+		}
 		receiver.ReleaseReceiver();
 		bInitialized = false;
 	}
+	// The last frame is not valid for another sender
+	bLastFrame = false;
+	ClearHistory();
+	// Sender frame numbers and access statistics restart
+	LastSenderFrame = 0;
+	LastSenderSample = 0LL;
+	LastAccessTimeouts = 0LL;
+}
+
+// Copy the last frame received to the sample buffer
+bool CVCamStream::CopyLastFrame(BYTE *pData, unsigned int size)
+{
+	if (!pData || !bLastFrame || !m_pLastFrame || size != m_LastFrameSize)
+		return false;
+	CopyMemory(pData, m_pLastFrame, size);
+	return true;
+}
+
+// Save a new frame for re-use while the sender frame is unchanged
+void CVCamStream::SaveLastFrame(const BYTE *pData, unsigned int size)
+{
+	if (!pData || size == 0)
+		return;
+	if (!m_pLastFrame || size != m_LastFrameSize) {
+		if (m_pLastFrame) delete[] m_pLastFrame;
+		m_pLastFrame = new BYTE[size];
+		m_LastFrameSize = size;
+	}
+	CopyMemory(m_pLastFrame, pData, size);
+	bLastFrame = true;
+}
+
+// Add a new sender frame to the history with the sender frame time
+void CVCamStream::AddHistoryFrame(const BYTE *pData, unsigned int size)
+{
+	if (!pData || size == 0)
+		return;
+
+	// The sender time of the frame in the pixels, recorded when
+	// ReceiveImage copied it. Zero if the sender has no control block.
+	const LONG64 frametime = receiver.GetImageTime();
+	if (frametime == 0) {
+		ClearHistory();
+		return;
+	}
+
+	// Same time as the newest frame
+	if (m_HistoryCount > 0 && frametime == m_HistoryTime[m_HistoryIndex])
+		return;
+
+	if (size != m_HistorySize) {
+		for (int i = 0; i < SPOUTCAM_HISTORY; i++) {
+			if (m_pHistory[i]) delete[] m_pHistory[i];
+			m_pHistory[i] = new BYTE[size];
+		}
+		m_HistorySize = size;
+		m_HistoryCount = 0;
+	}
+
+	m_HistoryIndex = (m_HistoryIndex + 1) % SPOUTCAM_HISTORY;
+	CopyMemory(m_pHistory[m_HistoryIndex], pData, size);
+	m_HistoryTime[m_HistoryIndex] = frametime;
+	if (m_HistoryCount < SPOUTCAM_HISTORY)
+		m_HistoryCount++;
+}
+
+// Replace the sample with the frame for the sample start time.
+// The stream time is converted to the SpoutUtils clock from the graph clock now.
+// The target is one sender frame period behind the sample time
+// so that it normally falls between two received frames.
+bool CVCamStream::ConvertFrame(BYTE *pData, unsigned int size, REFERENCE_TIME rtStart)
+{
+	if (!pData || m_HistoryCount == 0 || size != m_HistorySize)
+		return false;
+
+	SpoutFrameControl control{};
+	if (!receiver.frame.GetFrameControl(&control) || control.period <= 0)
+		return false;
+
+	const REFERENCE_TIME rtAhead = (refStart + rtStart) - GetClockTime();
+	const LONG64 target = GetClockTicks()
+		+ MillisecondsToClockTicks((double)rtAhead/10000.0) - control.period;
+
+	// Newest frame at or before the target time
+	// and the frame after it, oldest first
+	int before = -1;
+	int after = -1;
+	for (int i = m_HistoryCount - 1; i >= 0; i--) {
+		const int index = (m_HistoryIndex - i + SPOUTCAM_HISTORY) % SPOUTCAM_HISTORY;
+		if (m_HistoryTime[index] <= target) {
+			before = index;
+		}
+		else {
+			after = index;
+			break;
+		}
+	}
+
+	// Target older than all frames or newer than all frames
+	if (before < 0 || after < 0) {
+		const int index = (before < 0) ? after : before;
+		CopyMemory(pData, m_pHistory[index], size);
+		return true;
+	}
+
+	const LONG64 span = m_HistoryTime[after] - m_HistoryTime[before];
+	const unsigned int weight = (span > 0)
+		? (unsigned int)(((target - m_HistoryTime[before])*256)/span) : 256;
+
+	if (dwConvert == 1) {
+		// Nearest frame
+		CopyMemory(pData, m_pHistory[(weight < 128) ? before : after], size);
+	}
+	else {
+		// Linear blend of the two frames
+		receiver.spoutcopy.BlendPixels(m_pHistory[before], m_pHistory[after], pData, size, weight);
+	}
+	return true;
+}
+
+// Clear the frame history
+void CVCamStream::ClearHistory()
+{
+	m_HistoryCount = 0;
+	m_HistoryIndex = 0;
+}
+
+// Set the sample time to the time the sender produced the frame.
+//
+// The frame time and number are those of the pixels delivered, from
+// the staging texture read by ReceiveImage. The sender time is converted
+// to the graph clock from the age of the frame now, and to stream time
+// from the clock time of the first sample. A repeated frame (frametime 0)
+// is timed now. Sample times always increase.
+// The media time is the sender frame number.
+void CVCamStream::SetSenderTime(IMediaSample *pms, LONG64 frametime, long framenumber)
+{
+	const REFERENCE_TIME rtClock = GetClockTime();
+	REFERENCE_TIME rtStart = rtClock - refStart;
+	if (frametime != 0) {
+		const LONG64 age = GetClockTicks() - frametime;
+		if (age > 0)
+			rtStart -= (REFERENCE_TIME)ClockTicksToReferenceTime(age);
+	}
+	if (rtStart <= m_rtSenderStart)
+		rtStart = m_rtSenderStart + 1;
+	m_rtSenderStart = rtStart;
+
+	REFERENCE_TIME rtEnd = rtStart + g_FrameTime;
+	pms->SetTime(&rtStart, &rtEnd);
+
+	if (framenumber > 0) {
+		LONGLONG llStart = (LONGLONG)framenumber;
+		LONGLONG llEnd = llStart + 1;
+		pms->SetMediaTime(&llStart, &llEnd);
+	}
+}
+
+// Record dropped frames numbered from "first".
+// Only the most recent SPOUTCAM_DROPPED are kept.
+// Called from the streaming thread, GetDroppedInfo from the application.
+void CVCamStream::AddDroppedFrames(long long frames, long long first)
+{
+	CAutoLock cAutoLock(&m_cSharedState);
+	const long long recorded = (frames < SPOUTCAM_DROPPED) ? frames : SPOUTCAM_DROPPED;
+	for (long long i = frames - recorded; i < frames; i++) {
+		m_DroppedFrames[m_DroppedIndex] = (long)(first + i);
+		m_DroppedIndex = (m_DroppedIndex + 1) % SPOUTCAM_DROPPED;
+		if (m_DroppedCount < SPOUTCAM_DROPPED)
+			m_DroppedCount++;
+	}
+	NumDroppedFrames += frames;
+}
+
+// Count sender frames skipped since the last new frame
+// and frames not read because texture access timed out.
+// If the output frame rate is lower than the sender, the sender frames
+// expected in the samples since the last new frame are not dropped.
+void CVCamStream::CountReceivedFrame(bool bNewFrame)
+{
+	SpoutAccessStats stats{};
+	if (receiver.GetAccessStats(stats)) {
+		// Statistics restart when the receiver connects
+		if (stats.timeouts < LastAccessTimeouts)
+			LastAccessTimeouts = 0LL;
+		if (stats.timeouts > LastAccessTimeouts) {
+			const long long timeouts = stats.timeouts - LastAccessTimeouts;
+			NumTimeoutFrames += timeouts;
+			// The texture is accessed once for each sample
+			// so the timeouts are of this and the preceding samples
+			AddDroppedFrames(timeouts, NumFrames - timeouts + 1);
+		}
+		LastAccessTimeouts = stats.timeouts;
+	}
+
+	if (bNewFrame) {
+		const long senderframe = receiver.GetSenderFrame();
+		if (LastSenderFrame > 0 && senderframe > LastSenderFrame + 1) {
+			long long skipped = (long long)(senderframe - LastSenderFrame - 1);
+			// Sender frames in the output time since the last new frame
+			const double fps = receiver.GetSenderFps();
+			const long long samples = NumFrames - LastSenderSample;
+			long long expected = 0LL;
+			if (fps > 0.0 && samples > 0)
+				expected = (long long)(fps*(double)(samples*g_FrameTime)/10000000.0 + 0.5) - 1LL;
+			if (expected > 0LL) {
+				const long long decimated = (expected < skipped) ? expected : skipped;
+				NumDecimatedFrames += decimated;
+				skipped -= decimated;
+			}
+			if (skipped > 0LL) {
+				NumSkippedFrames += skipped;
+				// Sender frame numbers of those before the new frame
+				AddDroppedFrames(skipped, (long long)senderframe - skipped);
+			}
+		}
+		LastSenderFrame = senderframe;
+		LastSenderSample = NumFrames;
+	}
 }
 
 
@@ -1172,8 +1684,22 @@ HRESULT CVCamStream::OnThreadCreate()
 {
     m_rtLastTime = 0;
 	dwLastTime = 0;
-	NumDroppedFrames = 0;
 	NumFrames = 0;
+	NumLateFrames = 0;
+	NumSkippedFrames = 0;
+	NumDecimatedFrames = 0;
+	NumTimeoutFrames = 0;
+	NumFrameBytes = 0;
+	LateSlots = 0;
+	{
+		CAutoLock cAutoLock(&m_cSharedState);
+		NumDroppedFrames = 0;
+		m_DroppedCount = 0;
+		m_DroppedIndex = 0;
+	}
+	m_rtSenderStart = -1;
+	NumNewFrames = 0;
+	NumRepeatedFrames = 0;
 
     return NOERROR;
 
@@ -1315,19 +1841,42 @@ HRESULT STDMETHODCALLTYPE CVCamStream::GetNumDropped (long* plDropped)
 	if (!plDropped) 
 		return E_POINTER;
 	
-	*plDropped=NumDroppedFrames;
+	CAutoLock cAutoLock(&m_cSharedState);
+	*plDropped=(long)NumDroppedFrames;
 		return NOERROR;
 }
 
+// Numbers of the most recent dropped frames, oldest first.
+// Output sample numbers for late frames and texture access timeouts,
+// sender frame numbers for skipped sender frames.
 HRESULT STDMETHODCALLTYPE CVCamStream::GetDroppedInfo (long lSize,long *plArraym,long* plNumCopied)
 {
-	return E_NOTIMPL;
+	if (!plArraym || !plNumCopied)
+		return E_POINTER;
+	if (lSize <= 0)
+		return E_INVALIDARG;
+
+	CAutoLock cAutoLock(&m_cSharedState);
+	const int count = (lSize < (long)m_DroppedCount) ? (int)lSize : m_DroppedCount;
+	// Oldest of the most recent "count" frames
+	int index = (m_DroppedIndex - count + SPOUTCAM_DROPPED) % SPOUTCAM_DROPPED;
+	for (int i = 0; i < count; i++) {
+		plArraym[i] = m_DroppedFrames[index];
+		index = (index + 1) % SPOUTCAM_DROPPED;
+	}
+	*plNumCopied = count;
+
+	return NOERROR;
 }
 
+// Average size of the frames delivered
 HRESULT STDMETHODCALLTYPE CVCamStream::GetAverageFrameSize (long* plAverageSize)
 {
 	if(!plAverageSize)return E_POINTER;
-	*plAverageSize=307200; // 640x480
+	if (NumFrames > 0)
+		*plAverageSize = (long)(NumFrameBytes/NumFrames);
+	else
+		*plAverageSize = (long)(g_Width*g_Height*3); // rgb
 	return S_OK;
 }
 
@@ -10,6 +10,13 @@
 //	17.10.19 - Clean up for DirectX methods
 //	13.10.20 - Clean up unused variables
 //	20.10.20 - Clean up std::chrono debugging
+//	18.10.26 - Add last frame buffer and new/repeated frame counts
+//			 - Add event driven receive option
+//			 - Add frame history for frame rate conversion
+//			 - Add sender frame rate option
+//			 - Add texture access wait option
+//			 - Count late, skipped and timed out frames for IAMDroppedFrames
+//			 - Add sender time option for sample times
 //
 
 #pragma once
@@ -18,6 +25,12 @@
 
 #define DECLARE_PTR(type, ptr, expr) type* ptr = (type*)(expr);
 
+// Number of sender frames kept for frame rate conversion
+#define SPOUTCAM_HISTORY 3
+
+// Number of dropped frame numbers kept for GetDroppedInfo
+#define SPOUTCAM_DROPPED 64
+
 // leak checking
 // http://www.codeproject.com/Articles/9815/Visual-Leak-Detector-Enhanced-Memory-Leak-Detectio
 //
@@ -28,6 +41,7 @@
 #define CRTDBG_MAP_ALLOC
 #include <stdlib.h>
 #include <crtdbg.h>
+#include <math.h>
 
 #include "..\SpoutDX\source\SpoutDX.h"
 #include <streams.h>
@@ -200,8 +214,24 @@ public:
 	
 	HRESULT put_Settings(DWORD dwFps, DWORD dwResolution, DWORD dwMirror, DWORD dwSwap, DWORD dwFlip, const char *name); //VS
 	void SetFps(DWORD dwFps);
+	void UpdateSenderFps();
+	static DWORD NearestFps(double fps);
 	void SetResolution(DWORD dwResolution);
 	void ReleaseCamReceiver();
+	bool CopyLastFrame(BYTE *pData, unsigned int size);
+	void SaveLastFrame(const BYTE *pData, unsigned int size);
+	// Frame rate conversion from the sender frame times
+	void AddHistoryFrame(const BYTE *pData, unsigned int size);
+	bool ConvertFrame(BYTE *pData, unsigned int size, REFERENCE_TIME rtStart);
+	void ClearHistory();
+	// Dropped frame accounting
+	void AddDroppedFrames(long long frames, long long first);
+	void CountReceivedFrame(bool bNewFrame);
+	// Sample time from the sender frame time
+	void SetSenderTime(IMediaSample *pms, LONG64 frametime, long framenumber);
+	// Frames received from the sender and frames repeated because it had not changed
+	long long GetNewFrames() { return NumNewFrames; }
+	long long GetRepeatedFrames() { return NumRepeatedFrames; }
 
 	// ============== IPC functions ==============
 	//
@@ -217,6 +247,14 @@ public:
 	bool bInvert;                // Flip vertically
 	bool bInitialized;
 	bool bDXinitialized;
+	bool bFrameSync;             // Wait for a new sender frame
+	bool bSenderFps;             // Output frame rate follows the sender
+	DWORD dwFpsCheck;            // Time of the last sender frame rate check
+	DWORD dwConvert;             // Frame rate conversion 0 - off, 1 - nearest frame, 2 - blend
+	bool bSenderTime;            // Sample times from the sender frame time
+	bool bSenderFound;           // Active sender found by the last check
+	long SenderChanges;          // Sender change count at the last check
+	DWORD dwSenderCheck;         // Time of the last check for the active sender
 
 	unsigned int g_Width;			 // The global filter image width
 	unsigned int g_Height;			 // The global filter image height
@@ -229,13 +267,45 @@ public:
 private:
 
 	CVCam *m_pParent;
+	REFERENCE_TIME GetClockTime();
 	long long NumDroppedFrames, NumFrames;
+	long long NumLateFrames;     // Output frames late past their time
+	long long NumSkippedFrames;  // Sender frames not received because the receiver was slower
+	long long NumDecimatedFrames; // Sender frames not required for a lower output frame rate
+	long long NumTimeoutFrames;  // Frames not read because texture access timed out
+	long long NumFrameBytes;     // Total size of the frames delivered
+	long long LateSlots;         // Frame times behind schedule
+	long LastSenderFrame;        // Sender frame number of the last new frame
+	long long LastSenderSample;  // Sample number of the last new frame
+	long long LastAccessTimeouts;
+
+	// Numbers of recent dropped frames, locked by m_cSharedState.
+	// Sample numbers, or sender frame numbers for skipped frames.
+	long m_DroppedFrames[SPOUTCAM_DROPPED];
+	int m_DroppedCount;
+	int m_DroppedIndex;
+	long long NumNewFrames, NumRepeatedFrames;
+
+	// Copy of the last frame received for re-use if the sender frame is unchanged
+	BYTE *m_pLastFrame;
+	unsigned int m_LastFrameSize;
+	bool bLastFrame;
+
+	// Recent sender frames and their sender time for frame rate conversion
+	BYTE *m_pHistory[SPOUTCAM_HISTORY];
+	LONG64 m_HistoryTime[SPOUTCAM_HISTORY];
+	unsigned int m_HistorySize;
+	int m_HistoryCount;			// Number of valid frames
+	int m_HistoryIndex;			// Index of the newest frame
 	REFERENCE_TIME 
 		m_rtLastTime,	// running timestamp
 		refSync1,		// Graphmanager clock time, to compute dropped frames.
 		refSync2,		// Clock time for Sleeping each frame if not dropping.
 		refStart,		// Real time at start from Graphmanager clock time.
-		rtStreamOff;	// IAMPushSource Get/Set data member.
+		rtStreamOff,	// IAMPushSource Get/Set data member.
+		m_rtSenderStart, // Start time of the last sample timed by the sender
+		m_rtSenderPeriod, // Sample period for the sender frame rate
+		m_rtPacingOffset; // Schedule offset after a change of sample period
 
 	DWORD dwLastTime;
     CCritSec m_cSharedState;
@@ -180,28 +180,29 @@ HRESULT CSpoutCamProperties::OnActivate()
 	////////////////////////////////////////
 
 	// Retrieve fps from registry
-	if (!ReadDwordFromRegistry(HKEY_CURRENT_USER, "Software\\Leading Edge\\SpoutCam", "fps", &dwValue) || dwValue > 5)
+	if (!ReadDwordFromRegistry(HKEY_CURRENT_USER, "Software\\Leading Edge\\SpoutCam", "fps", &dwValue) || dwValue > 6)
 	{
 		dwValue = 3; // default 3 = 30 fps
 	}
 
 	hwndCtl = GetDlgItem(this->m_Dlg, IDC_FPS);
 	
-	WCHAR fps_values[6][3] =
+	WCHAR fps_values[7][7] =
 	{
 		L"10",
 		L"15",
 		L"25",
 		L"30", // default
 		L"50",
-		L"60"
+		L"60",
+		L"Sender" // follow the sender frame rate
 	};
 
-	WCHAR fps[3];
+	WCHAR fps[7];
 	int k = 0;
 
 	memset(&fps, 0, sizeof(fps));
-	for (k = 0; k <= 5; k += 1)
+	for (k = 0; k <= 6; k += 1)
 	{
 		wcscpy_s(fps, sizeof(fps) / sizeof(WCHAR), fps_values[k]);
 		ComboBox_AddString(hwndCtl, fps);